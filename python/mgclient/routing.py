@@ -14,14 +14,21 @@
 
 """Client-side routing for Memgraph high-availability clusters.
 
-This is a thin, Pythonic facade over libmgclient's routing engine, exposed by
-the :mod:`mgclient._mgclient` C extension as ``_Router``. The engine -- routing
-table fetch and caching (with TTL), read load-balancing, coordinator failover
-and the managed-transaction retry loop -- lives in libmgclient and is shared
-with every other driver built on it; this module only adapts it to an ergonomic
-Python API.
+This is a thin, Pythonic facade over the routing engine exposed by the
+:mod:`mgclient._mgclient` C extension as ``_Router``. Routing-table fetch and
+coordinator failover come from libmgclient's ``mg_router``; the extension
+caches the table (with TTL), keeps pools of idle sessions to the data
+instances, balances reads and runs the managed-transaction retry loop. This
+module only adapts it to an ergonomic Python API.
 """
 
+import os
+import queue
+import threading
+import time
+import weakref
+from collections import OrderedDict
+
 from mgclient._mgclient import _Router
 from mgclient._mgclient import connect as _base_connect
 from mgclient._mgclient import TransientError
@@ -36,6 +43,82 @@ _ACCESS_MODES = (ACCESS_MODE_WRITE, ACCESS_MODE_READ)
 _DEFAULT_MAX_RETRIES = 8
 _DEFAULT_RETRY_BACKOFF = 1.0
 _DEFAULT_RETRY_BACKOFF_CAP = 15.0
+_DEFAULT_MAX_IDLE_SESSIONS = 4
+_DEFAULT_MAX_IDLE = 600.0
+_DEFAULT_FAILURE_THRESHOLD = 3
+_DEFAULT_FAILURE_COOLDOWN = 5.0
+# Seconds between background refresh attempts after a failure, and the least
+# time between two refreshes.
+_BACKGROUND_RETRY_DELAY = 1.0
+# Seconds after which a thread running hedged read attempts ends if no more
+# have come in.
+_HEDGE_WORKER_IDLE_TIMEOUT = 60.0
+
+# Routers shared by connect(routing=True) calls with the same parameters, most
+# recently used last. Bounded so that ever-changing parameters (for example a
+# new resolver closure per call) can't grow it without limit.
+_MAX_CACHED_ROUTERS = 16
+_routers = OrderedDict()
+_routers_lock = threading.Lock()
+# Routers a forked child inherited from its parent. Their sessions share
+# sockets with the parent's, so the child never uses or closes them.
+_inherited_routers = []
+
+
+class _Workers:
+    """Daemon threads running hedged read attempts, so that a hedged read
+    doesn't pay for starting threads. They are started when all are busy and
+    end after ``idle_timeout`` seconds without work."""
+
+    def __init__(self, idle_timeout):
+        self._idle_timeout = idle_timeout
+        self._tasks = queue.SimpleQueue()
+        self._lock = threading.Lock()
+        # Threads waiting for a task that no submitted task is counted on.
+        self._idle = 0
+
+    def submit(self, fn, *args):
+        with self._lock:
+            spawn = self._idle == 0
+            if not spawn:
+                self._idle -= 1
+        self._tasks.put((fn, args))
+        if spawn:
+            threading.Thread(
+                target=self._run, name="mgclient-hedged-read", daemon=True
+            ).start()
+
+    def _run(self):
+        while True:
+            try:
+                fn, args = self._tasks.get(timeout=self._idle_timeout)
+            except queue.Empty:
+                with self._lock:
+                    # Unless a task was just submitted counting on this thread.
+                    if self._idle:
+                        self._idle -= 1
+                        return
+                continue
+            fn(*args)
+            with self._lock:
+                self._idle += 1
+
+
+_hedge_workers = _Workers(_HEDGE_WORKER_IDLE_TIMEOUT)
+
+
+def _reset_after_fork():
+    global _routers, _routers_lock, _hedge_workers
+    _inherited_routers.extend(_routers.values())
+    _routers = OrderedDict()
+    # Another thread of the parent may have held the lock when it forked.
+    _routers_lock = threading.Lock()
+    # The parent's workers don't exist in the child.
+    _hedge_workers = _Workers(_HEDGE_WORKER_IDLE_TIMEOUT)
+
+
+if hasattr(os, "register_at_fork"):
+    os.register_at_fork(after_in_child=_reset_after_fork)
 
 
 def is_transient_error(exc):
@@ -75,6 +158,10 @@ class Router:
     example ``username``, ``password`` and the SSL options) are reused for both
     the coordinator and the data-instance connections.
 
+    A :class:`Router` can be shared by many threads. Each managed transaction
+    and connection gets a session of its own, and network waits (connecting,
+    fetching the routing table and running queries) don't hold the GIL.
+
     Parameters:
 
        * :obj:`host` / :obj:`address` / :obj:`port`
@@ -98,6 +185,45 @@ class Router:
             :meth:`execute_write`). Backoff is capped exponential:
             ``retry_backoff``, ``2 * retry_backoff``, ... up to
             ``retry_backoff_cap`` seconds.
+
+       * :obj:`max_idle_sessions`
+
+            The most idle sessions kept open per data instance, so that
+            managed transactions and connections from :meth:`connect` reuse
+            them instead of connecting anew (0 disables reuse). A connection
+            from :meth:`connect` returns its session when it is closed outside
+            of a transaction. Sessions to instances that drop out of the
+            routing table are closed.
+
+       * :obj:`max_idle`
+
+            Seconds after which an idle session is closed rather than reused
+            (0 to reuse sessions however long they were idle), as the server
+            or a firewall may have dropped it in the meantime. If a managed
+            transaction finds a reused session broken, the other idle sessions
+            to that instance are closed and the transaction is retried on a new
+            session right away, without backoff and without counting towards
+            :obj:`max_retries` or the circuit breaker.
+
+       * :obj:`failure_threshold` / :obj:`failure_cooldown`
+
+            The circuit breaker of each data instance. After
+            ``failure_threshold`` transport failures in a row (connecting
+            failed or a session broke), the instance is skipped for
+            ``failure_cooldown`` seconds. After that, one request first checks
+            it with a trivial query, and the instance is used again only if
+            that succeeds. 0 disables the breaker.
+
+       * :obj:`background_refresh`
+
+            If given, a fraction of the routing table's TTL (between 0 and 1)
+            after which a background thread fetches a new table and swaps it
+            in, so that requests don't wait for the table to be refreshed when
+            it expires. The thread leaves fetching the first table to the
+            router's first use. A failed background refresh is retried every
+            second while the current table stays in use. Call :meth:`close` to
+            stop the thread; it also stops once the router is garbage
+            collected.
     """
 
     def __init__(
@@ -111,8 +237,15 @@ class Router:
         max_retries=_DEFAULT_MAX_RETRIES,
         retry_backoff=_DEFAULT_RETRY_BACKOFF,
         retry_backoff_cap=_DEFAULT_RETRY_BACKOFF_CAP,
+        max_idle_sessions=_DEFAULT_MAX_IDLE_SESSIONS,
+        max_idle=_DEFAULT_MAX_IDLE,
+        failure_threshold=_DEFAULT_FAILURE_THRESHOLD,
+        failure_cooldown=_DEFAULT_FAILURE_COOLDOWN,
+        background_refresh=None,
         **connect_kwargs,
     ):
+        if background_refresh is not None and not 0 < background_refresh < 1:
+            raise ValueError("background_refresh must be between 0 and 1")
         # Forward only the parameters that were actually given; the C _Router
         # applies its own defaults for anything omitted.
         params = {
@@ -131,9 +264,23 @@ class Router:
             max_retries=max_retries,
             retry_backoff=retry_backoff,
             retry_backoff_cap=retry_backoff_cap,
+            max_idle_sessions=max_idle_sessions,
+            max_idle=max_idle,
+            failure_threshold=failure_threshold,
+            failure_cooldown=failure_cooldown,
             **params,
         )
 
+        self._stop_refresh = threading.Event()
+        weakref.finalize(self, self._stop_refresh.set)
+        if background_refresh is not None:
+            threading.Thread(
+                target=_refresh_in_background,
+                args=(weakref.ref(self), self._stop_refresh, background_refresh),
+                name="mgclient-router-refresh",
+                daemon=True,
+            ).start()
+
     def connect(self, access_mode=ACCESS_MODE_WRITE):
         """Open a connection to a data instance serving ``access_mode``.
 
@@ -146,25 +293,45 @@ class Router:
             return self._router.connect_write()
         return self._router.connect_read()
 
-    def execute_read(self, work):
+    def execute_read(self, work, *, timeout=None, hedge_after=None):
         """Run ``work(cursor)`` as a managed read against a replica.
 
-        ``work`` receives a :class:`Cursor` from a freshly routed READ
-        connection and returns whatever the caller wants; that value is returned
-        from :meth:`execute_read`.  On a transient cluster condition (see
-        :func:`is_transient_error`) the routing table is refreshed and the work
-        is retried with capped exponential backoff, up to ``max_retries``.
+        ``work`` receives a :class:`Cursor` from a routed READ connection
+        (reusing an idle session when there is one) and returns whatever the
+        caller wants; that value is returned from :meth:`execute_read`.  On a
+        transient cluster condition (see :func:`is_transient_error`) the
+        routing table is refreshed and the work is retried with capped
+        exponential backoff, up to ``max_retries``.
+        The backoff doesn't hold the GIL and is cut short by signals such as
+        :exc:`KeyboardInterrupt`.
+
+        If ``timeout`` is given, no retry starts more than ``timeout`` seconds
+        after the call: when the next backoff would end past that point, the
+        last transient error is raised instead.
+
+        If ``hedge_after`` is given and the work hasn't finished that many
+        seconds after it started, it is started again on a different replica,
+        and the first of the two to succeed is returned. The other one is
+        discarded: it stops before its next call of ``work`` (or retry), and a
+        call already running is left to finish in the background with its
+        result dropped. This trades some extra load for a shorter tail latency
+        when a single replica stalls.
 
         ``work`` may be called more than once, so it should be free of side
         effects other than the database operations themselves.
         """
-        return self._router.execute_read(work)
+        if hedge_after is None:
+            return self._router.execute_read(work, timeout=timeout)
+        if hedge_after < 0:
+            raise ValueError("hedge_after must be non-negative")
+        return _hedged_read(self._router, work, timeout, hedge_after)
 
-    def execute_write(self, work):
+    def execute_write(self, work, *, timeout=None):
         """Run ``work(cursor)`` as a managed write against the main.
 
-        Like :meth:`execute_read`, but the work runs inside an explicit
-        transaction that is committed for you, and it is routed to the main.
+        Like :meth:`execute_read` (including ``timeout``), but the work runs
+        inside an explicit transaction that is committed for you, and it is
+        routed to the main.
 
         Transient failover conditions are retried.  A replication failure at
         commit is surfaced as an error like any other -- including a SYNC
@@ -174,10 +341,14 @@ class Router:
         retried write, make ``work`` idempotent (e.g. ``MERGE``) so a re-run
         after such an error cannot duplicate it.
         """
-        return self._router.execute_write(work)
+        return self._router.execute_write(work, timeout=timeout)
 
     def refresh(self):
-        """Force an immediate refresh of the cached routing table."""
+        """Force an immediate refresh of the cached routing table.
+
+        If another thread is already fetching a routing table, waits for that
+        fetch and shares its result instead of starting a second one.
+        """
         self._router.refresh()
 
     @property
@@ -186,6 +357,159 @@ class Router:
         ``"ttl"``, ``"write"``, ``"read"`` and ``"route"`` entries."""
         return self._router.routing_table()
 
+    def close(self):
+        """Stop the background refresh, if any, and close the idle sessions.
+
+        The router can still be used afterwards.
+        """
+        self._stop_refresh.set()
+        self._router.close_idle_sessions()
+
+    @property
+    def idle_sessions(self):
+        """The number of idle sessions kept for reuse, as a dict keyed by the
+        ``"host:port"`` address of the data instance."""
+        return self._router.idle_sessions()
+
+    @property
+    def instances(self):
+        """What the router observed about the data instances it used, as a
+        dict keyed by ``"host:port"`` address of dicts with ``"latency"`` (the
+        moving average of the seconds an instance took to answer a query, or
+        ``None`` before the first one), ``"in_flight"`` (sessions currently in
+        use or being opened), ``"idle"`` (idle sessions kept for reuse) and
+        ``"circuit_open"`` (whether the instance is skipped after failing, see
+        ``failure_threshold``)."""
+        return self._router.instances()
+
+
+class _HedgeLost(Exception):
+    """Stops the attempt of a hedged read that lost the race."""
+
+
+def _hedged_read(router, work, timeout, hedge_after):
+    """Runs a managed read, starting a second attempt on another replica if
+    the first one hasn't finished after ``hedge_after`` seconds."""
+    deadline = None if timeout is None else time.monotonic() + timeout
+    # The replicas tried by either attempt, which the other one tries last.
+    claimed = []
+    finished = threading.Event()
+    cond = threading.Condition()
+    # Attempt number -> (succeeded, result or exception).
+    outcomes = {}
+
+    def guarded(cursor):
+        if finished.is_set():
+            raise _HedgeLost()
+        return work(cursor)
+
+    def attempt(number, attempt_timeout):
+        try:
+            outcome = (
+                True,
+                router.execute_read(
+                    guarded, timeout=attempt_timeout, claimed=claimed
+                ),
+            )
+        except BaseException as exc:
+            outcome = (False, exc)
+        with cond:
+            outcomes[number] = outcome
+            cond.notify_all()
+
+    def start(number):
+        remaining = None
+        if deadline is not None:
+            remaining = max(deadline - time.monotonic(), 0)
+        _hedge_workers.submit(attempt, number, remaining)
+
+    def settled(started):
+        return (
+            any(ok for ok, _ in outcomes.values()) or len(outcomes) == started
+        )
+
+    try:
+        with cond:
+            start(0)
+            started = 1
+            if not cond.wait_for(lambda: settled(started), hedge_after):
+                start(1)
+                started = 2
+            cond.wait_for(lambda: settled(started))
+            results = dict(outcomes)
+    finally:
+        finished.set()
+
+    for ok, value in results.values():
+        if ok:
+            return value
+    raise results[0][1]
+
+
+def _refresh_in_background(router_ref, stop, fraction):
+    """Keeps the routing table of the router behind ``router_ref`` fresh until
+    ``stop`` is set or the router is garbage collected. The first table is
+    left to the router's first use; after that, a new one is fetched once
+    ``fraction`` of the TTL has passed since the last fetch (by this thread or
+    by a request)."""
+    delay = 0
+    while not stop.wait(delay):
+        router = router_ref()
+        if router is None:
+            return
+        delay = _BACKGROUND_RETRY_DELAY
+        age = router._router.table_age()
+        if age is not None:
+            seconds, ttl = age
+            due = max(fraction * ttl, _BACKGROUND_RETRY_DELAY) - seconds
+            if due > 0:
+                delay = due
+            else:
+                try:
+                    ttl = router._router.prefetch()
+                except Exception:
+                    ttl = None
+                if ttl is not None:
+                    delay = max(fraction * ttl, _BACKGROUND_RETRY_DELAY)
+        del router
+
+
+def _freeze(value):
+    """A hashable equivalent of a connection parameter value."""
+    if isinstance(value, dict):
+        return tuple(sorted((key, _freeze(item)) for key, item in value.items()))
+    if isinstance(value, list):
+        return tuple(_freeze(item) for item in value)
+    hash(value)
+    return value
+
+
+def _cached_router(resolver, routing_context, kwargs):
+    """The shared :class:`Router` for the given seed and connection parameters,
+    created on first use."""
+    try:
+        key = _freeze(
+            dict(kwargs, resolver=resolver, routing_context=routing_context)
+        )
+    except TypeError:
+        # Unhashable parameters: don't share the router.
+        return Router(resolver=resolver, routing_context=routing_context, **kwargs)
+
+    with _routers_lock:
+        router = _routers.get(key)
+        if router is not None:
+            _routers.move_to_end(key)
+            return router
+
+    router = Router(resolver=resolver, routing_context=routing_context, **kwargs)
+    with _routers_lock:
+        # Another thread may have created one meanwhile; keep the first.
+        router = _routers.setdefault(key, router)
+        _routers.move_to_end(key)
+        while len(_routers) > _MAX_CACHED_ROUTERS:
+            _routers.popitem(last=False)
+    return router
+
 
 def connect(
     *,
@@ -208,15 +532,16 @@ def connect(
     connection to a data instance serving ``access_mode`` (``"WRITE"`` -> the
     main, ``"READ"`` -> a replica). A ``resolver`` may be supplied (see
     :class:`Router`) for environments where advertised addresses are not
-    directly reachable. This is a one-shot convenience; construct a
-    :class:`Router` directly to reuse the cached routing table across
-    connections.
+    directly reachable.
+
+    Calls with the same seed address and connection parameters share one
+    :class:`Router`, kept for the life of the process, so they reuse its cached
+    routing table until its TTL expires (and its idle sessions) instead of
+    contacting a coordinator each time.
     """
     if not routing:
         return _base_connect(**kwargs)
 
     access_mode = _normalize_access_mode(access_mode)
-    router = Router(
-        resolver=resolver, routing_context=routing_context, **kwargs
-    )
+    router = _cached_router(resolver, routing_context, kwargs)
     return router.connect(access_mode=access_mode)
@@ -71,14 +71,17 @@ class BuildMgclientExt(build_ext):
 
     user_options = build_ext.user_options[:]
     user_options.append(("static-openssl", None, "Compile with statically linked OpenSSL."))
+    user_options.append(("timings", None, "Compile in the client-side timers of Cursor.timings."))
 
     boolean_options = build_ext.boolean_options[:]
     boolean_options.append(("static-openssl"))
+    boolean_options.append(("timings"))
 
     def initialize_options(self):
         super().initialize_options()
         # start with config default; this may get overridden by setup.cfg/CLI during finalize
         self.static_openssl = True
+        self.timings = False
 
     def finalize_options(self):
         super().finalize_options()
@@ -91,6 +94,14 @@ class BuildMgclientExt(build_ext):
             )
             self.static_openssl = static_ssl_env.strip().lower() in {"1", "true", "yes", "on"}
 
+        timings_env = os.getenv("PYMGCLIENT_TIMINGS")
+        if timings_env is not None:
+            self.announce(
+                f"Using timings from environment variable: {timings_env}",
+                level=log.INFO,
+            )
+            self.timings = timings_env.strip().lower() in {"1", "true", "yes", "on"}
+
     def run(self):
         """
         Perform build_cmake before doing the 'normal' stuff
@@ -100,6 +111,8 @@ class BuildMgclientExt(build_ext):
         for extension in self.extensions:
             if extension.name == EXTENSION_NAME:
                 self.build_mgclient_for(extension)
+                if self.timings:
+                    extension.define_macros.append(("PYMGCLIENT_TIMINGS", ""))
 
         if IS_WINDOWS:
             if self.compiler is None:
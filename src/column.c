@@ -86,6 +86,27 @@ int column_init(ColumnObject *column, PyObject *args, PyObject *kwargs) {
   return 0;
 }
 
+PyObject *column_from_name(PyObject *name) {
+  assert(PyUnicode_Check(name));
+  ColumnObject *column =
+      (ColumnObject *)ColumnType.tp_alloc(&ColumnType, 0);
+  if (!column) {
+    return NULL;
+  }
+  Py_INCREF(name);
+  column->name = name;
+  // The remaining fields are all None; set them without going through
+  // argument parsing in `column_init`.
+  PyObject **unsupported[] = {&column->type_code, &column->display_size,
+                              &column->internal_size, &column->precision,
+                              &column->scale, &column->null_ok};
+  for (size_t i = 0; i < sizeof(unsupported) / sizeof(*unsupported); ++i) {
+    Py_INCREF(Py_None);
+    *unsupported[i] = Py_None;
+  }
+  return (PyObject *)column;
+}
+
 PyDoc_STRVAR(ColumnType_name_doc, "name of the returned column");
 PyDoc_STRVAR(
     ColumnType_unsupported_doc,
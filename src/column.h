@@ -33,4 +33,7 @@ typedef struct {
 
 extern PyTypeObject ColumnType;
 
+// Creates a Column named `name`, equivalent to `Column(name)`.
+PyObject *column_from_name(PyObject *name);
+
 #endif
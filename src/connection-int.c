@@ -13,8 +13,13 @@
 // limitations under the License.
 
 #include "connection.h"
+
+#include <limits.h>
+
 #include "exceptions.h"
 #include "glue.h"
+#include "querystats.h"
+#include "trace.h"
 
 int connection_raise_if_bad_status(const ConnectionObject *conn) {
   if (conn->status == CONN_STATUS_BAD) {
@@ -25,10 +30,21 @@ int connection_raise_if_bad_status(const ConnectionObject *conn) {
     PyErr_SetString(InterfaceError, "session closed");
     return -1;
   }
+  if (conn->waiting) {
+    PyErr_SetString(InterfaceError, "connection is in use by another thread");
+    return -1;
+  }
   return 0;
 }
 
+// Status returned by the session wrappers below, with InterfaceError already
+// set, when another thread is using the connection.
+#define CONNECTION_BUSY INT_MIN
+
 void connection_handle_error(ConnectionObject *conn, int error) {
+  if (error == CONNECTION_BUSY) {
+    return;
+  }
   if (mg_session_status(conn->session) == MG_SESSION_BAD) {
     conn->status = CONN_STATUS_BAD;
   } else if (error == MG_ERROR_TRANSIENT_ERROR ||
@@ -39,19 +55,104 @@ void connection_handle_error(ConnectionObject *conn, int error) {
   // A transient failure (a server-signalled TransientError, or a low-level
   // transport failure worth retrying) surfaces as TransientError so callers can
   // retry it; mgclient owns the classification (see mg_error_is_transient).
-  PyObject *exc =
-      mg_error_is_transient(error) ? TransientError : DatabaseError;
+  PyObject *exc;
+  if (mg_error_is_transient(error)) {
+    conn->stats.transient_errors++;
+    exc = TransientError;
+  } else {
+    conn->stats.database_errors++;
+    exc = DatabaseError;
+  }
   PyErr_SetString(exc, mg_session_error(conn->session));
 }
 
+// Wrappers around the session calls that keep `conn->stats` up to date. They
+// wait for the server without holding the GIL, so other threads (for example
+// ones sharing a Router, each with its own session) keep running meanwhile.
+// `conn->waiting` stops another thread from using the session until then.
+
+static int connection_claim(ConnectionObject *conn) {
+  if (conn->waiting) {
+    PyErr_SetString(InterfaceError, "connection is in use by another thread");
+    return -1;
+  }
+  conn->waiting = 1;
+  return 0;
+}
+
+static int connection_session_run(ConnectionObject *conn, const char *query,
+                                  const mg_map *params,
+                                  const mg_list **columns) {
+  if (connection_claim(conn) < 0) {
+    return CONNECTION_BUSY;
+  }
+  conn->stats.round_trips++;
+  if (query_stats_enabled) {
+    conn->stats.bytes_sent +=
+        strlen(query) + (params ? mg_map_encoded_size(params) : 0);
+  }
+  int64_t start = timings_now();
+  int status;
+  Py_BEGIN_ALLOW_THREADS;
+  status = mg_session_run(conn->session, query, params, NULL, columns, NULL);
+  Py_END_ALLOW_THREADS;
+  conn->stats.wait_time += timings_now() - start;
+  conn->waiting = 0;
+  return status;
+}
+
+static int connection_session_pull(ConnectionObject *conn,
+                                   const mg_map *pull_information) {
+  if (connection_claim(conn) < 0) {
+    return CONNECTION_BUSY;
+  }
+  conn->stats.round_trips++;
+  int status;
+  Py_BEGIN_ALLOW_THREADS;
+  status = mg_session_pull(conn->session, pull_information);
+  Py_END_ALLOW_THREADS;
+  conn->waiting = 0;
+  return status;
+}
+
+// Also reports the approximate encoded size of a fetched record in `size` (if
+// not NULL). The size is only worked out when the caller or the byte counters
+// need it, as that walks the whole record.
+static int connection_session_fetch(ConnectionObject *conn,
+                                    mg_result **result, size_t *size) {
+  if (connection_claim(conn) < 0) {
+    return CONNECTION_BUSY;
+  }
+  int64_t start = timings_now();
+  int status;
+  Py_BEGIN_ALLOW_THREADS;
+  status = mg_session_fetch(conn->session, result);
+  Py_END_ALLOW_THREADS;
+  conn->stats.wait_time += timings_now() - start;
+  conn->waiting = 0;
+  if (status == 1) {
+    conn->stats.rows++;
+    if (size || query_stats_enabled) {
+      size_t record_size = mg_list_encoded_size(mg_result_row(*result));
+      if (query_stats_enabled) {
+        conn->stats.bytes_received += record_size;
+      }
+      if (size) {
+        *size = record_size;
+      }
+    }
+  }
+  return status;
+}
+
 int connection_run_without_results(ConnectionObject *conn, const char *query) {
-  int status = mg_session_run(conn->session, query, NULL, NULL, NULL, NULL);
+  int status = connection_session_run(conn, query, NULL, NULL);
   if (status != 0) {
     connection_handle_error(conn, status);
     return -1;
   }
 
-  status = mg_session_pull(conn->session, NULL);
+  status = connection_session_pull(conn, NULL);
   if (status != 0) {
     connection_handle_error(conn, status);
     return -1;
@@ -59,7 +160,7 @@ int connection_run_without_results(ConnectionObject *conn, const char *query) {
 
   while (1) {
     mg_result *result;
-    int status = mg_session_fetch(conn->session, &result);
+    int status = connection_session_fetch(conn, &result, NULL);
     if (status == 0) {
       break;
     }
@@ -81,23 +182,42 @@ int connection_run_without_results(ConnectionObject *conn, const char *query) {
 
 int connection_run(ConnectionObject *conn, const char *query, PyObject *params,
                    PyObject **columns) {
-  // This should be used to start the execution of a query, so we validate
-  // we're in a valid state for query execution.
-  assert((conn->autocommit && conn->status == CONN_STATUS_READY) ||
-         (!conn->autocommit && conn->status == CONN_STATUS_IN_TRANSACTION));
-
   mg_map *mg_params = NULL;
   if (params) {
-    mg_params = py_dict_to_mg_map(params);
+    mg_params = py_mapping_to_mg_map(params);
     if (!mg_params) {
       return -1;
     }
   }
+  return connection_run_encoded(conn, query, mg_params, columns);
+}
+
+// Keeps the summary of a completed result for the cursor to pick up.
+static void connection_keep_summary(ConnectionObject *conn,
+                                    const mg_result *result) {
+  PyObject *summary = mg_map_to_py_dict(mg_result_summary(result));
+  if (!summary) {
+    // Losing the summary isn't worth failing the query over.
+    PyErr_Clear();
+  }
+  Py_XSETREF(conn->summary, summary);
+}
+
+int connection_run_encoded(ConnectionObject *conn, const char *query,
+                           mg_map *params, PyObject **columns) {
+  // This should be used to start the execution of a query, so we validate
+  // we're in a valid state for query execution.
+  assert((conn->autocommit && conn->status == CONN_STATUS_READY) ||
+         (!conn->autocommit && conn->status == CONN_STATUS_IN_TRANSACTION));
+
+  Py_CLEAR(conn->summary);
 
   const mg_list *mg_columns;
-  int status =
-      mg_session_run(conn->session, query, mg_params, NULL, &mg_columns, NULL);
-  mg_map_destroy(mg_params);
+  TIMINGS_START(start);
+  conn->stats.queries++;
+  int status = connection_session_run(conn, query, params, &mg_columns);
+  TIMINGS_STOP(conn->timings, run, start);
+  mg_map_destroy(params);
 
   if (status != 0) {
     connection_handle_error(conn, status);
@@ -115,15 +235,26 @@ int connection_run(ConnectionObject *conn, const char *query, PyObject *params,
 int connection_pull(ConnectionObject *conn, long n) {
   assert(conn->status == CONN_STATUS_EXECUTING);
 
+  TIMINGS_START(start);
   int status;
   if (n == 0) {  // PULL_ALL
-    status = mg_session_pull(conn->session, NULL);
+    status = connection_session_pull(conn, NULL);
   } else {  // PULL_N
+    // mg_session_pull only reads the extra map, so it's ours to destroy once
+    // the message has been sent.
     mg_map *pull_information = mg_map_make_empty(1);
     mg_value *pull_info_n = mg_value_make_integer(n);
-    mg_map_insert(pull_information, "n", pull_info_n);
-    status = mg_session_pull(conn->session, pull_information);
+    if (!pull_information || !pull_info_n ||
+        mg_map_insert_unsafe(pull_information, "n", pull_info_n) != 0) {
+      mg_value_destroy(pull_info_n);
+      mg_map_destroy(pull_information);
+      PyErr_SetString(PyExc_RuntimeError, "failed to create a mg_map");
+      return -1;
+    }
+    status = connection_session_pull(conn, pull_information);
+    mg_map_destroy(pull_information);
   }
+  TIMINGS_STOP(conn->timings, pull, start);
   if (status == 0) {
     conn->status = CONN_STATUS_FETCHING;
     return 0;
@@ -135,15 +266,42 @@ int connection_pull(ConnectionObject *conn, long n) {
 
 int connection_fetch(ConnectionObject *conn, PyObject **row,
                      int *has_more_out) {
+  return connection_fetch_sized(conn, row, has_more_out, NULL);
+}
+
+int connection_fetch_sized(ConnectionObject *conn, PyObject **row,
+                           int *has_more_out, size_t *size_out) {
+  const mg_list *record;
+  int status = connection_fetch_raw(conn, &record, has_more_out, size_out);
+  if (status == 1 && row) {
+    TIMINGS_START(start);
+    PyObject *pyresult = mg_list_to_py_tuple(record);
+    TIMINGS_STOP(conn->timings, decode, start);
+    if (!pyresult) {
+      connection_discard_all(conn);
+      // the connection_handle_error mustn't be called here, as the error
+      // doesn't affect the status of the connection
+      return -1;
+    }
+    *row = pyresult;
+  }
+  return status;
+}
+
+int connection_fetch_raw(ConnectionObject *conn, const mg_list **record,
+                         int *has_more_out, size_t *size_out) {
   assert(conn->status == CONN_STATUS_FETCHING);
 
   mg_result *result;
-  int status = mg_session_fetch(conn->session, &result);
+  TIMINGS_START(start);
+  int status = connection_session_fetch(conn, &result, size_out);
+  TIMINGS_STOP(conn->timings, fetch, start);
   if (status == 0) {
     const mg_map *mg_summary = mg_result_summary(result);
     const mg_value *mg_has_more = mg_map_at(mg_summary, "has_more");
     const int has_more = mg_value_bool(mg_has_more);
     if (!has_more) {
+      connection_keep_summary(conn, result);
       conn->status =
           conn->autocommit ? CONN_STATUS_READY : CONN_STATUS_IN_TRANSACTION;
     } else {
@@ -164,15 +322,8 @@ int connection_fetch(ConnectionObject *conn, PyObject **row,
     connection_handle_error(conn, status);
     return -1;
   }
-  if (status == 1 && row) {
-    PyObject *pyresult = mg_list_to_py_tuple(mg_result_row(result));
-    if (!pyresult) {
-      connection_discard_all(conn);
-      // the connection_handle_error mustn't be called here, as the error
-      // doesn't affect the status of the connection
-      return -1;
-    }
-    *row = pyresult;
+  if (status == 1) {
+    *record = mg_result_row(result);
   }
   assert(status == 0 || status == 1);
   return status;
@@ -182,7 +333,10 @@ int connection_begin(ConnectionObject *conn) {
   assert(!conn->lazy && conn->status == CONN_STATUS_READY);
 
   // send BEGIN command and expect no results
-  if (connection_run_without_results(conn, "BEGIN") < 0) {
+  int64_t trace = trace_start("begin", NULL);
+  int status = connection_run_without_results(conn, "BEGIN");
+  trace_end(trace, "begin", NULL, -1, status < 0);
+  if (status < 0) {
     return -1;
   }
 
@@ -190,6 +344,78 @@ int connection_begin(ConnectionObject *conn) {
   return 0;
 }
 
+int connection_discard_rest(ConnectionObject *conn) {
+  assert(conn->status == CONN_STATUS_EXECUTING);
+  conn->discard_pending = 0;
+
+  // libmgclient can't send DISCARD, so pull the rest and drop each record as
+  // it arrives, without converting any of them.
+  TIMINGS_START(start);
+  int status = connection_session_pull(conn, NULL);
+  mg_result *result = NULL;
+  if (status == 0) {
+    while ((status = connection_session_fetch(conn, &result, NULL)) == 1)
+      ;
+  }
+  TIMINGS_STOP(conn->timings, fetch, start);
+  if (status < 0) {
+    connection_handle_error(conn, status);
+    return -1;
+  }
+
+  connection_keep_summary(conn, result);
+  conn->status =
+      conn->autocommit ? CONN_STATUS_READY : CONN_STATUS_IN_TRANSACTION;
+  return 0;
+}
+
+int connection_settle(ConnectionObject *conn) {
+  if (!conn->discard_pending) {
+    return 0;
+  }
+  if (connection_discard_rest(conn) < 0) {
+    return -1;
+  }
+  // Nobody is left to take the summary of the dropped result.
+  Py_CLEAR(conn->summary);
+  return 0;
+}
+
+int connection_reset(ConnectionObject *conn) {
+  if (conn->status == CONN_STATUS_EXECUTING &&
+      connection_discard_rest(conn) < 0) {
+    return -1;
+  }
+  Py_CLEAR(conn->summary);
+  if (conn->status == CONN_STATUS_IN_TRANSACTION) {
+    if (connection_run_without_results(conn, "ROLLBACK") < 0) {
+      return -1;
+    }
+    conn->status = CONN_STATUS_READY;
+  }
+  conn->autocommit = conn->lazy;
+  return 0;
+}
+
+int connection_ping(ConnectionObject *conn) {
+  assert(conn->status == CONN_STATUS_READY);
+
+  int status = connection_session_run(conn, "RETURN 1", NULL, NULL);
+  if (status == 0) {
+    status = connection_session_pull(conn, NULL);
+  }
+  if (status == 0) {
+    mg_result *result;
+    while ((status = connection_session_fetch(conn, &result, NULL)) == 1)
+      ;
+  }
+  if (status < 0) {
+    connection_handle_error(conn, status);
+    return -1;
+  }
+  return 0;
+}
+
 void connection_discard_all(ConnectionObject *conn) {
   assert(conn->status == CONN_STATUS_EXECUTING);
   assert(PyErr_Occurred());
@@ -203,10 +429,10 @@ void connection_discard_all(ConnectionObject *conn) {
     Py_XDECREF(traceback);
   }
 
-  int status = mg_session_pull(conn->session, NULL);
+  int status = connection_session_pull(conn, NULL);
   if (status == 0) {
     mg_result *result;
-    while ((status = mg_session_fetch(conn->session, &result)) == 1)
+    while ((status = connection_session_fetch(conn, &result, NULL)) == 1)
       ;
   }
 
@@ -19,11 +19,26 @@
 #include "cursor.h"
 #include "exceptions.h"
 #include "glue.h"
+#include "prepared.h"
+#include "trace.h"
+
+// Lets go of the connection's session, destroying it if owned.
+static void connection_drop_session(ConnectionObject *conn) {
+  if (conn->owns_session && conn->session) {
+    if (conn->session_release) {
+      conn->session_release(conn);
+    } else {
+      mg_session_destroy(conn->session);
+    }
+  }
+  conn->session = NULL;
+  Py_CLEAR(conn->session_home);
+  Py_CLEAR(conn->session_key);
+}
 
 static void connection_dealloc(ConnectionObject *conn) {
-  if (conn->owns_session) {
-    mg_session_destroy(conn->session);
-  }
+  connection_drop_session(conn);
+  Py_CLEAR(conn->summary);
   Py_TYPE(conn)->tp_free(conn);
 }
 
@@ -42,17 +57,21 @@ PyObject *connection_wrap_session(mg_session *session, int owns_session,
   return (PyObject *)conn;
 }
 
+// Called by mg_connect, which runs without the GIL held.
 static int execute_trust_callback(const char *hostname, const char *ip_address,
                                   const char *key_type, const char *fingerprint,
                                   PyObject *pycallback) {
+  PyGILState_STATE gil = PyGILState_Ensure();
   PyObject *result = PyObject_CallFunction(pycallback, "ssss", hostname,
                                            ip_address, key_type, fingerprint);
-  if (!result) {
-    return -1;
-  }
-  int status = PyObject_IsTrue(result);
-  Py_DECREF(result);
-  return !status;
+  int rc = -1;
+  if (result) {
+    int trusted = PyObject_IsTrue(result);
+    Py_DECREF(result);
+    rc = trusted < 0 ? -1 : !trusted;
+  }
+  PyGILState_Release(gil);
+  return rc;
 }
 
 static int connection_init(ConnectionObject *conn, PyObject *args,
@@ -127,7 +146,11 @@ static int connection_init(ConnectionObject *conn, PyObject *args,
 
   mg_session *session;
   {
-    int status = mg_connect(params, &session);
+    // The parameters point into the arguments, which the caller keeps alive.
+    int status;
+    Py_BEGIN_ALLOW_THREADS;
+    status = mg_connect(params, &session);
+    Py_END_ALLOW_THREADS;
     mg_session_params_destroy(params);
     if (status != 0) {
       // A connection that failed for a transient reason (e.g. an instance was
@@ -190,9 +213,14 @@ static PyObject *connection_close(ConnectionObject *conn, PyObject *args) {
 
   assert(!args);
 
-  if (conn->status == CONN_STATUS_EXECUTING) {
-    // This can only happen if connection is in lazy execution mode.
-    assert(conn->lazy);
+  if (conn->waiting) {
+    PyErr_SetString(InterfaceError, "connection is in use by another thread");
+    return NULL;
+  }
+  // The rest of a result cut short by `max_rows` goes with the session.
+  if (conn->status == CONN_STATUS_EXECUTING && !conn->discard_pending) {
+    // This can only happen in lazy execution mode or while a cursor with a
+    // buffer limit streams the result.
     PyErr_SetString(InterfaceError,
                     "cannot close connection during execution of a query");
     return NULL;
@@ -201,10 +229,7 @@ static PyObject *connection_close(ConnectionObject *conn, PyObject *args) {
   // No need to rollback, closing the connection will automatically
   // rollback any open transactions. A borrowed session is left intact for its
   // owner (the router); we only detach from it here.
-  if (conn->owns_session) {
-    mg_session_destroy(conn->session);
-  }
-  conn->session = NULL;
+  connection_drop_session(conn);
   conn->status = CONN_STATUS_CLOSED;
 
   Py_RETURN_NONE;
@@ -226,15 +251,21 @@ static PyObject *connection_commit(ConnectionObject *conn, PyObject *args) {
 
   assert(!args);
 
-  if (connection_raise_if_bad_status(conn) < 0) {
+  if (connection_raise_if_bad_status(conn) < 0 ||
+      connection_settle(conn) < 0) {
     return NULL;
   }
 
   if (conn->status == CONN_STATUS_EXECUTING) {
-    // This can only happen if connection is in lazy execution mode. In
-    // that case, autocommit must be enabled and this method does nothing.
-    assert(conn->lazy && conn->autocommit);
-    Py_RETURN_NONE;
+    // This can only happen in lazy execution mode, where autocommit is always
+    // enabled and this method does nothing, or while a cursor with a buffer
+    // limit streams the result.
+    if (conn->autocommit) {
+      Py_RETURN_NONE;
+    }
+    PyErr_SetString(InterfaceError,
+                    "cannot commit during execution of a query");
+    return NULL;
   }
 
   if (conn->autocommit || conn->status == CONN_STATUS_READY) {
@@ -244,7 +275,10 @@ static PyObject *connection_commit(ConnectionObject *conn, PyObject *args) {
   assert(conn->status == CONN_STATUS_IN_TRANSACTION);
 
   // send COMMIT command and expect no results
-  if (connection_run_without_results(conn, "COMMIT") < 0) {
+  int64_t trace = trace_start("commit", NULL);
+  int status = connection_run_without_results(conn, "COMMIT");
+  trace_end(trace, "commit", NULL, -1, status < 0);
+  if (status < 0) {
     return NULL;
   }
 
@@ -267,15 +301,21 @@ static PyObject *connection_rollback(ConnectionObject *conn, PyObject *args) {
   (void)args;
 
   assert(!args);
-  if (connection_raise_if_bad_status(conn) < 0) {
+  if (connection_raise_if_bad_status(conn) < 0 ||
+      connection_settle(conn) < 0) {
     return NULL;
   }
 
   if (conn->status == CONN_STATUS_EXECUTING) {
-    // This can only happen if connection is in lazy execution mode. In
-    // that case, autocommit must be enabled and this method does nothing.
-    assert(conn->lazy && conn->autocommit);
-    Py_RETURN_NONE;
+    // This can only happen in lazy execution mode, where autocommit is always
+    // enabled and this method does nothing, or while a cursor with a buffer
+    // limit streams the result.
+    if (conn->autocommit) {
+      Py_RETURN_NONE;
+    }
+    PyErr_SetString(InterfaceError,
+                    "cannot roll back during execution of a query");
+    return NULL;
   }
 
   if (conn->autocommit || conn->status == CONN_STATUS_READY) {
@@ -285,7 +325,10 @@ static PyObject *connection_rollback(ConnectionObject *conn, PyObject *args) {
   assert(conn->status == CONN_STATUS_IN_TRANSACTION);
 
   // send ROLLBACK command and expect no results
-  if (connection_run_without_results(conn, "ROLLBACK") < 0) {
+  int64_t trace = trace_start("rollback", NULL);
+  int status = connection_run_without_results(conn, "ROLLBACK");
+  trace_end(trace, "rollback", NULL, -1, status < 0);
+  if (status < 0) {
     return NULL;
   }
 
@@ -295,23 +338,60 @@ static PyObject *connection_rollback(ConnectionObject *conn, PyObject *args) {
 
 // clang-format off
 PyDoc_STRVAR(connection_cursor_doc,
-"cursor()\n\
+"cursor(*, consume=False, buffer_rows=0, buffer_bytes=0, spill_bytes=0)\n\
 --\n\
 \n\
-Return a new :class:`Cursor` object using the connection.");
+Return a new :class:`Cursor` object using the connection.\n\
+\n\
+If ``consume`` is ``True``, the cursor releases each buffered row as soon as\n\
+it has been fetched (see :attr:`Cursor.consume`).\n\
+\n\
+A non-zero ``buffer_rows`` or ``buffer_bytes`` limits how much of a result\n\
+:meth:`Cursor.execute()` buffers; a larger result is streamed in batches as\n\
+it is fetched (see :ref:`adaptive-execution`).\n\
+\n\
+A non-zero ``spill_bytes`` makes :meth:`Cursor.execute()` write the part of a\n\
+result beyond that many bytes to a temporary file (see :ref:`spilling`).");
 // clang-format on
 
-static PyObject *connection_cursor(ConnectionObject *conn, PyObject *args) {
-  // Unused args.
-  (void)args;
+static PyObject *connection_cursor(ConnectionObject *conn, PyObject *args,
+                                   PyObject *kwargs) {
+  if (PyTuple_GET_SIZE(args) > 0) {
+    PyErr_SetString(PyExc_TypeError,
+                    "cursor() takes no positional arguments");
+    return NULL;
+  }
 
-  assert(!args);
+  if (connection_raise_if_bad_status(conn) < 0) {
+    return NULL;
+  }
+
+  PyObject *cursor_args = PyTuple_Pack(1, (PyObject *)conn);
+  if (!cursor_args) {
+    return NULL;
+  }
+  PyObject *cursor =
+      PyObject_Call((PyObject *)&CursorType, cursor_args, kwargs);
+  Py_DECREF(cursor_args);
+  return cursor;
+}
+
+// clang-format off
+PyDoc_STRVAR(connection_prepare_doc,
+"prepare(query)\n\
+--\n\
+\n\
+Return a new :class:`PreparedQuery` for executing ``query`` repeatedly using\n\
+the connection.");
+// clang-format on
 
+static PyObject *connection_prepare(ConnectionObject *conn, PyObject *query) {
   if (connection_raise_if_bad_status(conn) < 0) {
     return NULL;
   }
 
-  return PyObject_CallFunctionObjArgs((PyObject *)&CursorType, conn, NULL);
+  return PyObject_CallFunctionObjArgs((PyObject *)&PreparedQueryType, conn,
+                                      query, NULL);
 }
 
 // clang-format off
@@ -348,6 +428,9 @@ int connection_autocommit_set(ConnectionObject *conn, PyObject *value,
                     "autocommit is always enabled in lazy mode");
     return -1;
   }
+  if (connection_settle(conn) < 0) {
+    return -1;
+  }
   if (conn->status == CONN_STATUS_EXECUTING ||
       conn->status == CONN_STATUS_IN_TRANSACTION) {
     PyErr_SetString(InterfaceError,
@@ -418,7 +501,8 @@ static PyObject *connection_get_routing_table(ConnectionObject *conn,
     return NULL;
   }
 
-  if (connection_raise_if_bad_status(conn) < 0) {
+  if (connection_raise_if_bad_status(conn) < 0 ||
+      connection_settle(conn) < 0) {
     return NULL;
   }
 
@@ -540,8 +624,10 @@ static PyMethodDef connection_methods[] = {
      connection_commit_doc},
     {"rollback", (PyCFunction)connection_rollback, METH_NOARGS,
      connection_rollback_doc},
-    {"cursor", (PyCFunction)connection_cursor, METH_NOARGS,
+    {"cursor", (PyCFunction)connection_cursor, METH_VARARGS | METH_KEYWORDS,
      connection_cursor_doc},
+    {"prepare", (PyCFunction)connection_prepare, METH_O,
+     connection_prepare_doc},
     {"get_routing_table", (PyCFunction)connection_get_routing_table,
      METH_VARARGS | METH_KEYWORDS, connection_get_routing_table_doc},
     {NULL, NULL, 0, NULL}};
@@ -569,7 +655,9 @@ It's value can be one of the following macros:\n\
 \n\
    * :data:`mgclient.CONN_STATUS_EXECUTING`\n\
         The connection is currently executing a query. This status\n\
-        can only be seen for lazy connections.");
+        can only be seen for lazy connections, while a cursor with a\n\
+        buffer limit streams a result, and until the rest of a result\n\
+        cut short by ``max_rows`` is discarded.");
 // clang-format on
 
 static PyMemberDef connection_members[] = {
@@ -577,9 +665,44 @@ static PyMemberDef connection_members[] = {
      ConnectionType_status_doc},
     {NULL}};
 
+// clang-format off
+PyDoc_STRVAR(ConnectionType_stats_doc,
+"Counters of the work done by the connection since it was opened, as a\n\
+:class:`dict`:\n\
+\n\
+   * ``'queries'``: queries run with :meth:`Cursor.execute()`.\n\
+   * ``'rows'``: records received, including those dropped by ``max_rows``.\n\
+   * ``'bytes_sent'``, ``'bytes_received'``: approximate size of the queries,\n\
+     parameters and records sent and received. Only counted while\n\
+     :func:`enable_query_stats` is on, as sizing a record walks all of its\n\
+     values.\n\
+   * ``'round_trips'``: requests the server had to respond to, including\n\
+     transaction control.\n\
+   * ``'transient_errors'``, ``'database_errors'``: failed requests, by the\n\
+     class of the raised exception.\n\
+   * ``'wait_time'``: seconds spent waiting for the server.");
+// clang-format on
+
+static PyObject *connection_stats_get(ConnectionObject *conn, void *data) {
+  (void)data;
+  const ConnectionStats *stats = &conn->stats;
+  return Py_BuildValue(
+      "{s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:d}", "queries",
+      (unsigned long long)stats->queries, "rows",
+      (unsigned long long)stats->rows, "bytes_sent",
+      (unsigned long long)stats->bytes_sent, "bytes_received",
+      (unsigned long long)stats->bytes_received, "round_trips",
+      (unsigned long long)stats->round_trips, "transient_errors",
+      (unsigned long long)stats->transient_errors, "database_errors",
+      (unsigned long long)stats->database_errors, "wait_time",
+      stats->wait_time / 1e9);
+}
+
 static PyGetSetDef connection_getset[] = {
     {"autocommit", (getter)connection_autocommit_get,
      (setter)connection_autocommit_set, ConnectionType_autocommit_doc, NULL},
+    {"stats", (getter)connection_stats_get, NULL, ConnectionType_stats_doc,
+     NULL},
     {NULL}};
 
 // clang-format off
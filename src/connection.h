@@ -19,6 +19,8 @@
 
 #include <mgclient.h>
 
+#include "timings.h"
+
 // Connection status constants.
 #define CONN_STATUS_READY 0
 #define CONN_STATUS_IN_TRANSACTION 1
@@ -27,6 +29,19 @@
 #define CONN_STATUS_CLOSED 4
 #define CONN_STATUS_BAD (-1)
 
+// Counters of the work done by a connection, see `Connection.stats`.
+typedef struct {
+  uint64_t queries;
+  uint64_t rows;
+  uint64_t bytes_sent;
+  uint64_t bytes_received;
+  uint64_t round_trips;
+  uint64_t transient_errors;
+  uint64_t database_errors;
+  // Nanoseconds spent waiting for the server.
+  int64_t wait_time;
+} ConnectionStats;
+
 // clang-format off
 typedef struct ConnectionObject {
   PyObject_HEAD
@@ -35,10 +50,31 @@ typedef struct ConnectionObject {
   int status;
   int autocommit;
   int lazy;
+  // Whether a thread is waiting for the server on this connection, with the
+  // GIL released.
+  int waiting;
+  // Whether the rest of a result cut short by `max_rows` is still to be
+  // discarded. The connection stays CONN_STATUS_EXECUTING until the session is
+  // needed again (see `connection_settle`).
+  int discard_pending;
   // Whether closing/deallocating this connection destroys `session`. A routed
   // managed transaction hands its work callback a *borrowed* connection over a
   // session owned by the router, which must outlive the wrapper.
   int owns_session;
+  // If set, an owned session is handed to `session_release(conn)` when the
+  // connection lets go of it, instead of being destroyed, so that a Router can
+  // reuse it if it is still usable and learn from the connection's stats.
+  PyObject *session_home;
+  PyObject *session_key;
+  void (*session_release)(struct ConnectionObject *conn);
+  // Summary of the last completed result as a dict, until a cursor takes it.
+  PyObject *summary;
+  ConnectionStats stats;
+#ifdef PYMGCLIENT_TIMINGS
+  // Timings of the current query, for the cursor executing it (not owned).
+  Timings timings;
+  struct CursorObject *timings_owner;
+#endif
 } ConnectionObject;
 // clang-format on
 
@@ -59,12 +95,45 @@ int connection_run_without_results(ConnectionObject *conn, const char *query);
 int connection_run(ConnectionObject *conn, const char *query, PyObject *params,
                    PyObject **columns);
 
+// Like `connection_run`, but with parameters the caller has already encoded.
+// `params` may be NULL and is always destroyed before returning.
+int connection_run_encoded(ConnectionObject *conn, const char *query,
+                           mg_map *params, PyObject **columns);
+
 int connection_pull(ConnectionObject *conn, long n);
 
 int connection_fetch(ConnectionObject *conn, PyObject **row, int *has_more);
 
+// Like `connection_fetch`, but also reports the approximate encoded size of a
+// fetched row in `size` (if not NULL).
+int connection_fetch_sized(ConnectionObject *conn, PyObject **row,
+                           int *has_more, size_t *size);
+
+// Like `connection_fetch_sized`, but hands out the received record itself
+// instead of converting it. The record is owned by the session and is valid
+// only until the next fetch.
+int connection_fetch_raw(ConnectionObject *conn, const mg_list **record,
+                         int *has_more, size_t *size);
+
 int connection_begin(ConnectionObject *conn);
 
 void connection_discard_all(ConnectionObject *conn);
 
+// Drops the records of the current result that haven't been pulled yet, once
+// the caller has all it wants. Returns -1 with an exception set on failure.
+int connection_discard_rest(ConnectionObject *conn);
+
+// Discards the rest of a result cut short by `max_rows`, if any, so that the
+// session can be used again. Returns -1 with an exception set on failure.
+int connection_settle(ConnectionObject *conn);
+
+// Brings the connection back to the state of a new one, dropping the result
+// being received and rolling back the open transaction. Returns -1 with an
+// exception set on failure.
+int connection_reset(ConnectionObject *conn);
+
+// Runs a trivial query to check that the server can still be reached. Returns
+// -1 with an exception set on failure.
+int connection_ping(ConnectionObject *conn);
+
 #endif
@@ -19,19 +19,76 @@
 #include "column.h"
 #include "connection.h"
 #include "exceptions.h"
+#include "glue.h"
+#include "summary.h"
+#include "trace.h"
+
+// Number of rows requested per PULL by a cursor that only has a byte budget.
+#define ADAPTIVE_PULL_SIZE 1000
+
+// Makes the connection measure the query `cursor` is about to run, leaving
+// the timings of the previous query with the cursor that ran it.
+static void cursor_claim_timings(CursorObject *cursor) {
+#ifdef PYMGCLIENT_TIMINGS
+  ConnectionObject *conn = cursor->conn;
+  if (conn->timings_owner && conn->timings_owner != cursor) {
+    conn->timings_owner->timings = conn->timings;
+  }
+  conn->timings_owner = cursor;
+  TIMINGS_RESET(conn->timings);
+#else
+  (void)cursor;
+#endif
+}
+
+// Takes the timings of the cursor's last query back from the connection
+// before the cursor lets go of it.
+static void cursor_release_timings(CursorObject *cursor) {
+#ifdef PYMGCLIENT_TIMINGS
+  if (cursor->conn && cursor->conn->timings_owner == cursor) {
+    cursor->timings = cursor->conn->timings;
+    cursor->conn->timings_owner = NULL;
+  }
+#else
+  (void)cursor;
+#endif
+}
 
 static void cursor_dealloc(CursorObject *cursor) {
+  cursor_release_timings(cursor);
   Py_CLEAR(cursor->conn);
   Py_CLEAR(cursor->rows);
   Py_CLEAR(cursor->description);
+  Py_CLEAR(cursor->summary);
+  spill_destroy(cursor->spill);
   Py_TYPE(cursor)->tp_free(cursor);
 }
 
 int cursor_init(CursorObject *cursor, PyObject *args, PyObject *kwargs) {
   ConnectionObject *conn = NULL;
+  int consume = 0;
+  Py_ssize_t buffer_rows = 0;
+  Py_ssize_t buffer_bytes = 0;
+  Py_ssize_t spill_bytes = 0;
+
+  static char *kwlist[] = {"",           "consume",     "buffer_rows",
+                           "buffer_bytes", "spill_bytes", NULL};
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$pnnn", kwlist, &conn,
+                                   &consume, &buffer_rows, &buffer_bytes,
+                                   &spill_bytes)) {
+    return -1;
+  }
 
-  static char *kwlist[] = {"", NULL};
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &conn)) {
+  if (buffer_rows < 0 || buffer_bytes < 0 || spill_bytes < 0) {
+    PyErr_SetString(
+        PyExc_ValueError,
+        "buffer_rows, buffer_bytes and spill_bytes must be non-negative");
+    return -1;
+  }
+  if (spill_bytes && (buffer_rows || buffer_bytes)) {
+    PyErr_SetString(PyExc_ValueError,
+                    "spill_bytes can't be combined with buffer_rows or "
+                    "buffer_bytes");
     return -1;
   }
 
@@ -47,8 +104,15 @@ int cursor_init(CursorObject *cursor, PyObject *args, PyObject *kwargs) {
   cursor->status = CURSOR_STATUS_READY;
   cursor->hasresults = 0;
   cursor->arraysize = 1;
+  cursor->consume = consume;
+  cursor->buffer_rows = buffer_rows;
+  cursor->buffer_bytes = buffer_bytes;
+  cursor->rowsreceived = 0;
+  cursor->spill_bytes = spill_bytes;
+  cursor->spill = NULL;
   cursor->rows = NULL;
   cursor->description = NULL;
+  cursor->summary = NULL;
   return 0;
 }
 
@@ -62,6 +126,7 @@ PyObject *cursor_new(PyTypeObject *subtype, PyObject *args, PyObject *kwargs) {
     return NULL;
   }
   ((CursorObject *)cursor)->status = CURSOR_STATUS_CLOSED;
+  ((CursorObject *)cursor)->query_stats.slot = -1;
   return cursor;
 }
 
@@ -70,11 +135,195 @@ PyObject *cursor_new(PyTypeObject *subtype, PyObject *args, PyObject *kwargs) {
 static void cursor_reset(CursorObject *cursor) {
   Py_CLEAR(cursor->rows);
   Py_CLEAR(cursor->description);
+  Py_CLEAR(cursor->summary);
+  spill_destroy(cursor->spill);
+  cursor->spill = NULL;
   cursor->hasresults = 0;
   cursor->rowcount = -1;
+  cursor->rowsreceived = 0;
+  cursor->query_stats.slot = -1;
   cursor->status = CURSOR_STATUS_READY;
 }
 
+// Takes the summary of the result the cursor has just finished receiving
+// from its connection, and records the query in `mgclient.query_stats()`.
+static void cursor_take_summary(CursorObject *cursor) {
+  query_stats_end(&cursor->query_stats, cursor->conn->stats.rows,
+                  cursor->conn->stats.bytes_received);
+  PyObject *data = cursor->conn->summary;
+  cursor->conn->summary = NULL;
+  Py_CLEAR(cursor->summary);
+  if (data) {
+    if (!(cursor->summary = result_summary_from_dict(data))) {
+      PyErr_Clear();
+    }
+    Py_DECREF(data);
+  }
+}
+
+// Whether the cursor buffers only part of a large result and streams the rest
+// (eager mode only).
+static int cursor_is_adaptive(const CursorObject *cursor) {
+  return !cursor->conn->lazy &&
+         (cursor->buffer_rows > 0 || cursor->buffer_bytes > 0);
+}
+
+// Pulls the next batch of records of an adaptive cursor's result and appends
+// them to its buffer, adding their approximate size to `bytes` (if not NULL).
+// Returns 1 if the server has more records, 0 if the result is complete and -1
+// on error, in which case the cursor is reset.
+static int cursor_pull_batch(CursorObject *cursor, Py_ssize_t *bytes) {
+  long n = cursor->buffer_rows > 0 ? (long)cursor->buffer_rows
+                                   : ADAPTIVE_PULL_SIZE;
+  if (connection_pull(cursor->conn, n) != 0) {
+    cursor_reset(cursor);
+    return -1;
+  }
+
+  int status;
+  int has_more = 0;
+  PyObject *row;
+  size_t size = 0;
+  while ((status = connection_fetch_sized(cursor->conn, &row, &has_more,
+                                          bytes ? &size : NULL)) == 1) {
+    int append_result = PyList_Append(cursor->rows, row);
+    Py_DECREF(row);
+    if (append_result < 0) {
+      connection_discard_all(cursor->conn);
+      cursor_reset(cursor);
+      return -1;
+    }
+    cursor->rowsreceived++;
+    if (bytes) {
+      *bytes += (Py_ssize_t)size;
+    }
+  }
+  if (status < 0) {
+    cursor_reset(cursor);
+    return -1;
+  }
+  return has_more;
+}
+
+// Replaces the fully fetched buffer of a streaming adaptive cursor with the
+// next batch of the result. Returns -1 on error.
+static int cursor_refill(CursorObject *cursor) {
+  assert(cursor->status == CURSOR_STATUS_EXECUTING);
+  PyObject *rows = PyList_New(0);
+  if (!rows) {
+    return -1;
+  }
+  Py_SETREF(cursor->rows, rows);
+  cursor->rowindex = 0;
+
+  int more = cursor_pull_batch(cursor, NULL);
+  if (more < 0) {
+    return -1;
+  }
+  if (!more) {
+    cursor->status = CURSOR_STATUS_READY;
+    cursor->rowcount = cursor->rowsreceived;
+    cursor_take_summary(cursor);
+  }
+  return 0;
+}
+
+// In consume mode, drops the buffer's references to the rows in [from, to)
+// that have just been handed out, so each row lives only as long as the caller
+// keeps it.
+static void cursor_release_rows(CursorObject *cursor, Py_ssize_t from,
+                                Py_ssize_t to) {
+  if (!cursor->consume) {
+    return;
+  }
+  // Spilled rows aren't held in memory anyway.
+  if (to > PyList_GET_SIZE(cursor->rows)) {
+    to = PyList_GET_SIZE(cursor->rows);
+  }
+  for (Py_ssize_t i = from; i < to; ++i) {
+    PyObject *row = PyList_GET_ITEM(cursor->rows, i);
+    Py_INCREF(Py_None);
+    PyList_SET_ITEM(cursor->rows, i, Py_None);
+    Py_DECREF(row);
+  }
+}
+
+// Number of rows of the result held by the cursor, in memory and spilled.
+static Py_ssize_t cursor_buffered(const CursorObject *cursor) {
+  return PyList_GET_SIZE(cursor->rows) +
+         (cursor->spill ? spill_size(cursor->spill) : 0);
+}
+
+// Returns a new reference to the held row at `index`.
+static PyObject *cursor_buffered_row(CursorObject *cursor, Py_ssize_t index) {
+  Py_ssize_t resident = PyList_GET_SIZE(cursor->rows);
+  if (index < resident) {
+    PyObject *row = PyList_GET_ITEM(cursor->rows, index);
+    Py_INCREF(row);
+    return row;
+  }
+  return spill_get(cursor->spill, index - resident);
+}
+
+// Returns a list of the held rows in [from, to).
+static PyObject *cursor_buffered_slice(CursorObject *cursor, Py_ssize_t from,
+                                       Py_ssize_t to) {
+  if (to <= PyList_GET_SIZE(cursor->rows)) {
+    return PyList_GetSlice(cursor->rows, from, to);
+  }
+  PyObject *rows = PyList_New(0);
+  if (!rows) {
+    return NULL;
+  }
+  for (Py_ssize_t i = from; i < to; ++i) {
+    PyObject *row = cursor_buffered_row(cursor, i);
+    if (!row || PyList_Append(rows, row) < 0) {
+      Py_XDECREF(row);
+      Py_DECREF(rows);
+      return NULL;
+    }
+    Py_DECREF(row);
+  }
+  return rows;
+}
+
+// Receives the pulled records, keeping rows in memory until their approximate
+// size exceeds `spill_bytes` and spilling the rest to a temporary file.
+static int cursor_fetch_spilling(CursorObject *cursor, int *has_more) {
+  Py_ssize_t bytes = 0;
+  const mg_list *record;
+  size_t size;
+  int status;
+  while ((status = connection_fetch_raw(cursor->conn, &record, has_more,
+                                        &size)) == 1) {
+    if (!cursor->spill) {
+      bytes += (Py_ssize_t)size;
+      if (bytes <= cursor->spill_bytes) {
+        TIMINGS_START(start);
+        PyObject *row = mg_list_to_py_tuple(record);
+        TIMINGS_STOP(cursor->conn->timings, decode, start);
+        if (!row || PyList_Append(cursor->rows, row) < 0) {
+          Py_XDECREF(row);
+          goto discard_all;
+        }
+        Py_DECREF(row);
+        continue;
+      }
+      if (!(cursor->spill = spill_new())) {
+        goto discard_all;
+      }
+    }
+    if (spill_append(cursor->spill, record) < 0) {
+      goto discard_all;
+    }
+  }
+  return status < 0 ? -1 : 0;
+
+discard_all:
+  connection_discard_all(cursor->conn);
+  return -1;
+}
+
 // clang-format off
 PyDoc_STRVAR(cursor_close_doc,
 "close()\n\
@@ -93,7 +342,6 @@ PyObject *cursor_close(CursorObject *cursor, PyObject *args) {
   assert(!args);
   if (cursor->status == CURSOR_STATUS_EXECUTING) {
     assert(cursor->conn->status == CONN_STATUS_EXECUTING);
-    assert(cursor->conn->lazy);
 
     // Cannot close cursor while executing a query because query execution might
     // raise an error.
@@ -102,6 +350,7 @@ PyObject *cursor_close(CursorObject *cursor, PyObject *args) {
     return NULL;
   }
 
+  cursor_release_timings(cursor);
   Py_CLEAR(cursor->conn);
   cursor_reset(cursor);
   cursor->status = CURSOR_STATUS_CLOSED;
@@ -109,39 +358,114 @@ PyObject *cursor_close(CursorObject *cursor, PyObject *args) {
   Py_RETURN_NONE;
 }
 
-static int cursor_set_description(CursorObject *cursor, PyObject *columns) {
-  assert(PyList_Check(columns));
+void description_cache_clear(DescriptionCache *cache) {
+  Py_CLEAR(cache->columns);
+  Py_CLEAR(cache->description);
+}
+
+// Descriptions shared by all cursors, keyed by the tuple of result column
+// names. High-rate queries tend to repeat a handful of projections, so this
+// saves building a Column object per column on every execute. Descriptions
+// are tuples, so sharing one between cursors is safe. The cache is simply
+// emptied when it fills up.
+#define SHARED_DESCRIPTIONS_CAPACITY 256
+static PyObject *shared_descriptions = NULL;
+
+static PyObject *shared_description(PyObject *columns) {
+  if (!shared_descriptions && !(shared_descriptions = PyDict_New())) {
+    return NULL;
+  }
+
+  PyObject *key = PyList_AsTuple(columns);
+  if (!key) {
+    return NULL;
+  }
+  PyObject *description = PyDict_GetItemWithError(shared_descriptions, key);
+  if (description) {
+    Py_DECREF(key);
+    Py_INCREF(description);
+    return description;
+  }
+  if (PyErr_Occurred()) {
+    Py_DECREF(key);
+    return NULL;
+  }
+
+  const Py_ssize_t size = PyTuple_GET_SIZE(key);
+  if (!(description = PyTuple_New(size))) {
+    Py_DECREF(key);
+    return NULL;
+  }
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    PyObject *name = PyTuple_GET_ITEM(key, i);
+    PyObject *entry = PyUnicode_Check(name)
+                          ? column_from_name(name)
+                          : PyObject_CallFunctionObjArgs(
+                                (PyObject *)&ColumnType, name, NULL);
+    if (!entry) {
+      Py_DECREF(key);
+      Py_DECREF(description);
+      return NULL;
+    }
+    PyTuple_SET_ITEM(description, i, entry);
+  }
+
+  if (PyDict_GET_SIZE(shared_descriptions) >= SHARED_DESCRIPTIONS_CAPACITY) {
+    PyDict_Clear(shared_descriptions);
+  }
+  int insert_status = PyDict_SetItem(shared_descriptions, key, description);
+  Py_DECREF(key);
+  if (insert_status < 0) {
+    Py_DECREF(description);
+    return NULL;
+  }
+  return description;
+}
+
+static int cursor_set_description(CursorObject *cursor, PyObject *columns,
+                                  DescriptionCache *cache) {
   assert(cursor->description == NULL);
   if (!columns) {
-    return 0;
-  }
-  PyObject *description = NULL;
-  if (!(description = PyList_New(PyList_Size(columns)))) {
     goto failure;
   }
-  for (Py_ssize_t i = 0; i < PyList_Size(columns); ++i) {
-    PyObject *entry = PyObject_CallFunctionObjArgs(
-        (PyObject *)&ColumnType, PyList_GetItem(columns, i), NULL);
-    if (!entry) {
+  assert(PyList_Check(columns));
+
+  if (cache && cache->columns) {
+    int same = PyObject_RichCompareBool(columns, cache->columns, Py_EQ);
+    if (same < 0) {
       goto failure;
     }
-    PyList_SET_ITEM(description, i, entry);
+    if (same) {
+      Py_INCREF(cache->description);
+      cursor->description = cache->description;
+      return 0;
+    }
+  }
+
+  PyObject *description = shared_description(columns);
+  if (!description) {
+    goto failure;
   }
 
   cursor->description = description;
+  if (cache) {
+    Py_INCREF(columns);
+    Py_XSETREF(cache->columns, columns);
+    Py_INCREF(description);
+    Py_XSETREF(cache->description, description);
+  }
   return 0;
 
 failure:
   if (PyErr_WarnEx(Warning, "failed to obtain result column names", 2) < 0) {
     return -1;
   }
-  Py_XDECREF(description);
   return 0;
 }
 
 // clang-format off
 PyDoc_STRVAR(cursor_execute_doc,
-"execute(query, params=None)\n\
+"execute(query, params=None, *, max_rows=0)\n\
 --\n\
 \n\
 Execute a database operation.\n\
@@ -150,48 +474,74 @@ Parameters may be provided as a mapping and will be bound to variables in\n\
 the operation. Variables are specified with named (``$name``)\n\
 placeholders.\n\
 \n\
+If ``max_rows`` is not 0, only the first ``max_rows`` rows of the result are\n\
+pulled and kept, and this method returns once they are in. The query still\n\
+runs to completion on the server, and the rest of the result is received\n\
+and dropped, without being converted to Python objects, when the connection\n\
+is next used (for the next query, commit or rollback). Closing the\n\
+connection instead drops it with the session. The result summary is not\n\
+available then. This is not supported on lazy connections and by cursors\n\
+with a buffer limit.\n\
+\n\
 This method always returns ``None``.\n");
 // clang-format on
 
-PyObject *cursor_execute(CursorObject *cursor, PyObject *args) {
-  const char *query = NULL;
-  PyObject *pyparams = NULL;
-  if (!PyArg_ParseTuple(args, "s|O", &query, &pyparams)) {
-    return NULL;
-  }
-
+int cursor_begin_execute(CursorObject *cursor) {
   if (cursor->status == CURSOR_STATUS_CLOSED) {
     PyErr_SetString(InterfaceError, "cursor closed");
-    return NULL;
+    return -1;
   }
 
-  if (connection_raise_if_bad_status(cursor->conn) < 0) {
-    return NULL;
+  if (connection_raise_if_bad_status(cursor->conn) < 0 ||
+      connection_settle(cursor->conn) < 0) {
+    return -1;
   }
 
   if (cursor->conn->status == CONN_STATUS_EXECUTING) {
-    assert(cursor->conn->lazy);
     PyErr_SetString(InterfaceError,
                     "cannot call execute during execution of a query");
-    return NULL;
+    return -1;
   }
 
   assert(cursor->status == CURSOR_STATUS_READY);
 
   cursor_reset(cursor);
+  return 0;
+}
+
+static PyObject *cursor_run(CursorObject *cursor, const char *query,
+                            mg_map *params, Py_ssize_t max_rows,
+                            DescriptionCache *cache) {
+  if (max_rows < 0) {
+    mg_map_destroy(params);
+    PyErr_SetString(PyExc_ValueError, "max_rows must be non-negative");
+    return NULL;
+  }
+  if (max_rows && (cursor->conn->lazy || cursor_is_adaptive(cursor))) {
+    mg_map_destroy(params);
+    PyErr_SetString(NotSupportedError,
+                    "max_rows can only be used by cursors buffering the "
+                    "whole result");
+    return NULL;
+  }
+
+  cursor_claim_timings(cursor);
+  query_stats_begin(&cursor->query_stats, query, cursor->conn->stats.rows,
+                    cursor->conn->stats.bytes_received);
 
   if (!cursor->conn->autocommit && cursor->conn->status == CONN_STATUS_READY) {
     if (connection_begin(cursor->conn) < 0) {
+      mg_map_destroy(params);
       goto cleanup;
     }
   }
 
   PyObject *columns;
-  if (connection_run(cursor->conn, query, pyparams, &columns) < 0) {
+  if (connection_run_encoded(cursor->conn, query, params, &columns) < 0) {
     goto cleanup;
   }
 
-  if (cursor_set_description(cursor, columns) < 0) {
+  if (cursor_set_description(cursor, columns, cache) < 0) {
     Py_XDECREF(columns);
     goto cleanup;
   }
@@ -210,27 +560,66 @@ PyObject *cursor_execute(CursorObject *cursor, PyObject *args) {
     goto discard_all;
   }
 
+  // Pull in batches until the result is complete or over the buffer budget,
+  // and stream the remainder as it is fetched.
+  if (cursor_is_adaptive(cursor)) {
+    Py_ssize_t bytes = 0;
+    int more;
+    do {
+      more = cursor_pull_batch(cursor, cursor->buffer_bytes ? &bytes : NULL);
+      if (more < 0) {
+        return NULL;
+      }
+    } while (more &&
+             !(cursor->buffer_rows &&
+               PyList_GET_SIZE(cursor->rows) >= cursor->buffer_rows) &&
+             !(cursor->buffer_bytes && bytes >= cursor->buffer_bytes));
+
+    cursor->hasresults = 1;
+    cursor->rowindex = 0;
+    if (more) {
+      cursor->status = CURSOR_STATUS_EXECUTING;
+      cursor->rowcount = -1;
+    } else {
+      cursor->rowcount = cursor->rowsreceived;
+      cursor_take_summary(cursor);
+    }
+    Py_RETURN_NONE;
+  }
+
+  // PULL_ALL, unless limited to the first max_rows records.
   int status;
-  status = connection_pull(cursor->conn, 0);  // PULL_ALL
+  status = connection_pull(cursor->conn, (long)max_rows);
   if (status != 0) {
     goto cleanup;
   }
 
-  PyObject *row;
-  while ((status = connection_fetch(cursor->conn, &row, NULL)) == 1) {
-    int append_result = PyList_Append(cursor->rows, row);
-    Py_DECREF(row);
-    if (append_result < 0) {
-      goto discard_all;
+  int has_more = 0;
+  if (cursor->spill_bytes) {
+    if (cursor_fetch_spilling(cursor, &has_more) < 0) {
+      goto cleanup;
+    }
+  } else {
+    PyObject *row;
+    while ((status = connection_fetch(cursor->conn, &row, &has_more)) == 1) {
+      int append_result = PyList_Append(cursor->rows, row);
+      Py_DECREF(row);
+      if (append_result < 0) {
+        goto discard_all;
+      }
+    }
+    if (status < 0) {
+      goto cleanup;
     }
   }
-  if (status < 0) {
-    goto cleanup;
-  }
+  // The rest of the result is discarded only once the session is needed
+  // again, so that execute returns as soon as the rows asked for are in.
+  cursor->conn->discard_pending = has_more;
+  cursor_take_summary(cursor);
 
   cursor->hasresults = 1;
   cursor->rowindex = 0;
-  cursor->rowcount = PyList_Size(cursor->rows);
+  cursor->rowcount = cursor_buffered(cursor);
   Py_RETURN_NONE;
 
 discard_all:
@@ -241,6 +630,40 @@ cleanup:
   return NULL;
 }
 
+PyObject *cursor_run_encoded(CursorObject *cursor, const char *query,
+                             mg_map *params, Py_ssize_t max_rows,
+                             DescriptionCache *cache) {
+  int64_t trace = trace_start("execute", query);
+  PyObject *result = cursor_run(cursor, query, params, max_rows, cache);
+  trace_end(trace, "execute", query, result ? cursor->rowcount : -1, !result);
+  return result;
+}
+
+PyObject *cursor_execute(CursorObject *cursor, PyObject *args,
+                         PyObject *kwargs) {
+  static char *kwlist[] = {"query", "params", "max_rows", NULL};
+  const char *query = NULL;
+  PyObject *pyparams = NULL;
+  Py_ssize_t max_rows = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|O$n", kwlist, &query,
+                                   &pyparams, &max_rows)) {
+    return NULL;
+  }
+
+  if (cursor_begin_execute(cursor) < 0) {
+    return NULL;
+  }
+
+  mg_map *params = NULL;
+  if (pyparams) {
+    if (!(params = py_mapping_to_mg_map(pyparams))) {
+      return NULL;
+    }
+  }
+
+  return cursor_run_encoded(cursor, query, params, max_rows, NULL);
+}
+
 // clang-format off
 PyDoc_STRVAR(cursor_fetchone_doc,
 "fetchone()\n\
@@ -306,6 +729,7 @@ PyObject *cursor_fetchone(CursorObject *cursor, PyObject *args) {
         cursor->status = CURSOR_STATUS_EXECUTING;
       } else {
         cursor->status = CURSOR_STATUS_READY;
+        cursor_take_summary(cursor);
       }
       Py_RETURN_NONE;
     } else if (fetch_status_first == 1) {
@@ -313,6 +737,7 @@ PyObject *cursor_fetchone(CursorObject *cursor, PyObject *args) {
         cursor->status = CURSOR_STATUS_EXECUTING;
       } else {
         cursor->status = CURSOR_STATUS_READY;
+        cursor_take_summary(cursor);
       }
       return row;
     } else {
@@ -321,10 +746,20 @@ PyObject *cursor_fetchone(CursorObject *cursor, PyObject *args) {
     }
   }
 
-  assert(cursor->rowcount >= 0);
-  if (cursor->rowindex < cursor->rowcount) {
-    PyObject *row = PyList_GET_ITEM(cursor->rows, cursor->rowindex++);
-    Py_INCREF(row);
+  while (cursor->rowindex == cursor_buffered(cursor) &&
+         cursor->status == CURSOR_STATUS_EXECUTING) {
+    if (cursor_refill(cursor) < 0) {
+      return NULL;
+    }
+  }
+
+  if (cursor->rowindex < cursor_buffered(cursor)) {
+    PyObject *row = cursor_buffered_row(cursor, cursor->rowindex);
+    if (!row) {
+      return NULL;
+    }
+    cursor_release_rows(cursor, cursor->rowindex, cursor->rowindex + 1);
+    cursor->rowindex++;
     return row;
   }
 
@@ -372,7 +807,7 @@ PyObject *cursor_fetchmany(CursorObject *cursor, PyObject *args,
     }
   }
 
-  if (cursor->conn->lazy) {
+  if (cursor->conn->lazy || cursor_is_adaptive(cursor)) {
     PyObject *results;
     if (!(results = PyList_New(0))) {
       return NULL;
@@ -390,7 +825,9 @@ PyObject *cursor_fetchmany(CursorObject *cursor, PyObject *args,
       Py_DECREF(row);
       if (append_result < 0) {
         Py_DECREF(results);
-        connection_discard_all(cursor->conn);
+        if (cursor->status == CURSOR_STATUS_EXECUTING) {
+          connection_discard_all(cursor->conn);
+        }
         cursor_reset(cursor);
         return NULL;
       }
@@ -404,9 +841,11 @@ PyObject *cursor_fetchmany(CursorObject *cursor, PyObject *args,
   Py_ssize_t new_rowindex = cursor->rowindex + size;
   new_rowindex =
       new_rowindex < cursor->rowcount ? new_rowindex : cursor->rowcount;
-  if (!(rows = PyList_GetSlice(cursor->rows, cursor->rowindex, new_rowindex))) {
+  if (!(rows = cursor_buffered_slice(cursor, cursor->rowindex,
+                                     new_rowindex))) {
     return NULL;
   }
+  cursor_release_rows(cursor, cursor->rowindex, new_rowindex);
   cursor->rowindex = new_rowindex;
   return rows;
 }
@@ -459,6 +898,7 @@ PyObject *cursor_fetchall(CursorObject *cursor, PyObject *args) {
       int fetch_status = connection_fetch(cursor->conn, &row, NULL);
       if (fetch_status == 0) {
         cursor->status = CURSOR_STATUS_READY;
+        cursor_take_summary(cursor);
         break;
       } else if (fetch_status == 1) {
         int append_result = PyList_Append(results, row);
@@ -483,17 +923,117 @@ PyObject *cursor_fetchall(CursorObject *cursor, PyObject *args) {
     return results;
   }
 
-  assert(cursor->rowcount >= 0);
+  if (cursor->status == CURSOR_STATUS_EXECUTING) {
+    // A streaming adaptive cursor: the caller asked for everything anyway, so
+    // pull the rest in one go after the rows still buffered.
+    PyObject *results;
+    if (!(results = PyList_GetSlice(cursor->rows, cursor->rowindex,
+                                    PyList_GET_SIZE(cursor->rows)))) {
+      return NULL;
+    }
+    cursor_release_rows(cursor, cursor->rowindex,
+                        PyList_GET_SIZE(cursor->rows));
+    cursor->rowindex = PyList_GET_SIZE(cursor->rows);
+    while (cursor->status == CURSOR_STATUS_EXECUTING) {
+      if (cursor_refill(cursor) < 0) {
+        Py_DECREF(results);
+        return NULL;
+      }
+      Py_ssize_t buffered = PyList_GET_SIZE(cursor->rows);
+      for (Py_ssize_t i = 0; i < buffered; ++i) {
+        if (PyList_Append(results, PyList_GET_ITEM(cursor->rows, i)) < 0) {
+          Py_DECREF(results);
+          if (cursor->status == CURSOR_STATUS_EXECUTING) {
+            connection_discard_all(cursor->conn);
+          }
+          cursor_reset(cursor);
+          return NULL;
+        }
+      }
+      cursor_release_rows(cursor, 0, buffered);
+      cursor->rowindex = buffered;
+    }
+    return results;
+  }
 
+  // The cursor holds the whole result, or an adaptive cursor's last batch.
+  Py_ssize_t buffered = cursor_buffered(cursor);
   PyObject *rows;
-  if (!(rows = PyList_GetSlice(cursor->rows, cursor->rowindex,
-                               cursor->rowcount))) {
+  if (!(rows = cursor_buffered_slice(cursor, cursor->rowindex, buffered))) {
     return NULL;
   }
-  cursor->rowindex = cursor->rowcount;
+  cursor_release_rows(cursor, cursor->rowindex, buffered);
+  cursor->rowindex = buffered;
   return rows;
 }
 
+// clang-format off
+PyDoc_STRVAR(cursor_scroll_doc,
+"scroll(value, mode='relative')\n\
+--\n\
+\n\
+Scroll the cursor in the result set to a new position.\n\
+\n\
+If ``mode`` is ``'relative'``, ``value`` is taken as an offset to the current\n\
+position, if it is ``'absolute'``, ``value`` is the target position. An\n\
+:exc:`IndexError` is raised if the new position would be outside of the\n\
+result set, in which case the position doesn't change.\n\
+\n\
+Scrolling needs the whole result to be held by the cursor, so a\n\
+:exc:`NotSupportedError` is raised for lazy connections, consuming cursors\n\
+and cursors still streaming the result.");
+// clang-format on
+
+PyObject *cursor_scroll(CursorObject *cursor, PyObject *args,
+                        PyObject *kwargs) {
+  static char *kwlist[] = {"value", "mode", NULL};
+  Py_ssize_t value;
+  const char *mode = "relative";
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|s", kwlist, &value,
+                                   &mode)) {
+    return NULL;
+  }
+
+  if (!cursor->hasresults) {
+    PyErr_SetString(InterfaceError, "no results available");
+    return NULL;
+  }
+
+  if (cursor->conn->lazy || cursor->consume ||
+      cursor->status == CURSOR_STATUS_EXECUTING || cursor->rowsreceived) {
+    PyErr_SetString(NotSupportedError,
+                    "scrolling needs the whole result held by the cursor");
+    return NULL;
+  }
+
+  Py_ssize_t position;
+  if (strcmp(mode, "relative") == 0) {
+    position = cursor->rowindex + value;
+  } else if (strcmp(mode, "absolute") == 0) {
+    position = value;
+  } else {
+    PyErr_Format(ProgrammingError, "scroll mode '%s' is not supported", mode);
+    return NULL;
+  }
+
+  if (position < 0 || position > cursor->rowcount) {
+    PyErr_SetString(PyExc_IndexError, "scroll out of result set range");
+    return NULL;
+  }
+  cursor->rowindex = position;
+  Py_RETURN_NONE;
+}
+
+static PyObject *cursor_iternext(CursorObject *cursor) {
+  PyObject *row = cursor_fetchone(cursor, NULL);
+  if (row == Py_None) {
+    // Exhausted: returning NULL without an exception set stops iteration.
+    Py_DECREF(row);
+    return NULL;
+  }
+  return row;
+}
+
 PyDoc_STRVAR(
     cursor_setinputsizes_doc,
     "This method does nothing, but it is required by the DB-API 2.0 spec.");
@@ -529,13 +1069,16 @@ PyObject *cursor_setoutputsizes(CursorObject *cursor, PyObject *args) {
 
 static PyMethodDef cursor_methods[] = {
     {"close", (PyCFunction)cursor_close, METH_NOARGS, cursor_close_doc},
-    {"execute", (PyCFunction)cursor_execute, METH_VARARGS, cursor_execute_doc},
+    {"execute", (PyCFunction)cursor_execute, METH_VARARGS | METH_KEYWORDS,
+     cursor_execute_doc},
     {"fetchone", (PyCFunction)cursor_fetchone, METH_NOARGS,
      cursor_fetchone_doc},
     {"fetchmany", (PyCFunction)cursor_fetchmany, METH_VARARGS | METH_KEYWORDS,
      cursor_fetchmany_doc},
     {"fetchall", (PyCFunction)cursor_fetchall, METH_NOARGS,
      cursor_fetchall_doc},
+    {"scroll", (PyCFunction)cursor_scroll, METH_VARARGS | METH_KEYWORDS,
+     cursor_scroll_doc},
     {"setinputsizes", (PyCFunction)cursor_setinputsizes, METH_VARARGS,
      cursor_setinputsizes_doc},
     {"setoutputsizes", (PyCFunction)cursor_setoutputsizes, METH_VARARGS,
@@ -548,7 +1091,8 @@ PyDoc_STRVAR(CursorType_rowcount_doc,
 :meth:`.execute()` produced.\n\
 \n\
 The attribute is -1 in case no :meth:`.execute()` has been performed or\n\
-the rowcount of the last operation cannot be determined by the interface.");
+the rowcount of the last operation cannot be determined by the interface,\n\
+e.g. while a cursor with a buffer limit is still streaming the result.");
 
 PyDoc_STRVAR(CursorType_arraysize_doc,
 "This read/write attribute specifies the number of rows to fetch at a time\n\
@@ -556,7 +1100,7 @@ with :meth:`.fetchmany()`. It defaults to 1 meaning to fetch a single row at\n\
 a time.");
 
 PyDoc_STRVAR(CursorType_description_doc,
-"This read-only attribute is a list of :class:`Column` objects.\n\
+"This read-only attribute is a tuple of :class:`Column` objects.\n\
 \n\
 Each of those object has attributed describing one result column:\n\
 \n\
@@ -572,9 +1116,55 @@ Only the name attribute is set to the name of column returned by the\n\
 database. The rest are always set to ``None`` and are only here for\n\
 compatibility with DB-API 2.0.\n\
 \n\
+Queries returning the same columns share the same description object.\n\
+\n\
 This attribute will be ``None`` for operations that do not return rows\n\
 or if the cursor has not had an operation invoked via the :meth:`.execute()`\n\
 method yet.");
+
+PyDoc_STRVAR(CursorType_consume_doc,
+"This read-only attribute specifies whether rows buffered by\n\
+:meth:`.execute()` are released as soon as they are fetched.\n\
+\n\
+It is set by passing ``consume=True`` to :meth:`Connection.cursor()`. Then the\n\
+cursor keeps only the rows that haven't been fetched yet, instead of holding\n\
+the whole result until the next :meth:`.execute()`. It has no effect on lazy\n\
+connections, which never buffer the result.");
+
+PyDoc_STRVAR(CursorType_buffer_rows_doc,
+"This read-only attribute specifies the most rows :meth:`.execute()` buffers\n\
+before streaming the rest of the result, or 0 if there is no such limit.\n\
+\n\
+It is set by passing ``buffer_rows`` to :meth:`Connection.cursor()`.");
+
+PyDoc_STRVAR(CursorType_buffer_bytes_doc,
+"This read-only attribute specifies the approximate number of bytes of\n\
+records :meth:`.execute()` buffers before streaming the rest of the result,\n\
+or 0 if there is no such limit.\n\
+\n\
+It is set by passing ``buffer_bytes`` to :meth:`Connection.cursor()`.");
+
+PyDoc_STRVAR(CursorType_summary_doc,
+"This read-only attribute is a :class:`ResultSummary` with the timings and\n\
+update counters the server reported for the last :meth:`.execute()`, or\n\
+``None`` until all of its results have been received.");
+
+PyDoc_STRVAR(CursorType_timings_doc,
+"This read-only attribute is a :class:`dict` with the time in seconds the\n\
+last query spent on the client side in each of its phases: ``'run'`` (sending\n\
+the query until the server accepted it), ``'pull'`` (requesting results),\n\
+``'fetch'`` (waiting for records) and ``'decode'`` (converting records to\n\
+Python objects).\n\
+\n\
+The timers are only compiled in if the extension is built with the\n\
+``--timings`` option, otherwise this attribute is always ``None``.");
+
+PyDoc_STRVAR(CursorType_spill_bytes_doc,
+"This read-only attribute specifies the approximate number of bytes of\n\
+records :meth:`.execute()` keeps in memory before writing the rest of the\n\
+result to a temporary file, or 0 if the result is never spilled.\n\
+\n\
+It is set by passing ``spill_bytes`` to :meth:`Connection.cursor()`.");
 // clang-format on
 
 static PyMemberDef cursor_members[] = {
@@ -584,6 +1174,46 @@ static PyMemberDef cursor_members[] = {
      CursorType_arraysize_doc},
     {"description", T_OBJECT, offsetof(CursorObject, description), READONLY,
      CursorType_description_doc},
+    {"buffer_rows", T_PYSSIZET, offsetof(CursorObject, buffer_rows), READONLY,
+     CursorType_buffer_rows_doc},
+    {"buffer_bytes", T_PYSSIZET, offsetof(CursorObject, buffer_bytes),
+     READONLY, CursorType_buffer_bytes_doc},
+    {"spill_bytes", T_PYSSIZET, offsetof(CursorObject, spill_bytes), READONLY,
+     CursorType_spill_bytes_doc},
+    {"summary", T_OBJECT, offsetof(CursorObject, summary), READONLY,
+     CursorType_summary_doc},
+    {NULL}};
+
+static PyObject *cursor_consume_get(CursorObject *cursor, void *data) {
+  (void)data;
+  if (cursor->consume) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+}
+
+static PyObject *cursor_timings_get(CursorObject *cursor, void *data) {
+  (void)data;
+#ifdef PYMGCLIENT_TIMINGS
+  const Timings *timings =
+      cursor->conn && cursor->conn->timings_owner == cursor
+          ? &cursor->conn->timings
+          : &cursor->timings;
+  return Py_BuildValue("{s:d,s:d,s:d,s:d}", "run", timings->run / 1e9,
+                       "pull", timings->pull / 1e9, "fetch",
+                       timings->fetch / 1e9, "decode", timings->decode / 1e9);
+#else
+  (void)cursor;
+  Py_RETURN_NONE;
+#endif
+}
+
+static PyGetSetDef cursor_getset[] = {
+    {"consume", (getter)cursor_consume_get, NULL, CursorType_consume_doc,
+     NULL},
+    {"timings", (getter)cursor_timings_get, NULL, CursorType_timings_doc,
+     NULL},
     {NULL}};
 
 // clang-format off
@@ -595,6 +1225,9 @@ bound to the connection for the entire lifetime. Cursors created by the same\n\
 connection are not isolated, any changes done to the database by one cursor\n\
 are immediately visible by the other cursors.\n\
 \n\
+Iterating over a cursor yields the remaining rows, as repeated calls to\n\
+:meth:`.fetchone()` would.\n\
+\n\
 Cursor objects are not thread-safe.");
 // clang-format on
 
@@ -607,8 +1240,11 @@ PyTypeObject CursorType = {
     .tp_dealloc = (destructor)cursor_dealloc,
     .tp_flags = Py_TPFLAGS_DEFAULT,
     .tp_doc = cursor_doc,
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc)cursor_iternext,
     .tp_methods = cursor_methods,
     .tp_members = cursor_members,
+    .tp_getset = cursor_getset,
     .tp_init = (initproc)cursor_init,
     .tp_new = (newfunc)cursor_new
 };
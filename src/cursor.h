@@ -17,6 +17,12 @@
 
 #include <Python.h>
 
+#include <mgclient.h>
+
+#include "querystats.h"
+#include "spill.h"
+#include "timings.h"
+
 struct ConnectionObject;
 
 #define CURSOR_STATUS_READY 0
@@ -24,21 +30,64 @@ struct ConnectionObject;
 #define CURSOR_STATUS_CLOSED 3
 
 // clang-format off
-typedef struct {
+typedef struct CursorObject {
   PyObject_HEAD
 
   struct ConnectionObject *conn;
   int status;
   int hasresults;
   long arraysize;
+  // In eager mode, drop buffered rows as soon as they are fetched.
+  int consume;
+  // In eager mode, the most rows / approximate bytes to buffer before
+  // switching to streaming the rest of the result (0 means no limit).
+  Py_ssize_t buffer_rows;
+  Py_ssize_t buffer_bytes;
+  // Rows received so far for the current result of an adaptive cursor.
+  Py_ssize_t rowsreceived;
+  // In eager mode, the approximate bytes of rows to keep in `rows` before
+  // writing the rest of the result to `spill` (0 means never spill).
+  Py_ssize_t spill_bytes;
+  Spill *spill;
 
   Py_ssize_t rowindex;
   Py_ssize_t rowcount;
   PyObject *rows;
   PyObject *description;
+  // ResultSummary of the last result, once it has been received completely.
+  PyObject *summary;
+  // The current query, for `mgclient.query_stats()`.
+  QueryStatsProbe query_stats;
+#ifdef PYMGCLIENT_TIMINGS
+  // Timings of the last query, once another query took over the connection.
+  Timings timings;
+#endif
 } CursorObject;
 // clang-format on
 
+// The result column names of the last query run with it and the description
+// built for them. Consecutive queries with the same projection then share one
+// description instead of building a new Column object per column.
+typedef struct {
+  PyObject *columns;
+  PyObject *description;
+} DescriptionCache;
+
+void description_cache_clear(DescriptionCache *cache);
+
 extern PyTypeObject CursorType;
 
+// Checks that `cursor` can start executing a new query and discards the
+// results of the previous one. Returns -1 with an exception set otherwise.
+int cursor_begin_execute(CursorObject *cursor);
+
+// Runs `query` on a cursor that passed `cursor_begin_execute`, with parameters
+// the caller has already encoded (`params` may be NULL and is always
+// destroyed), and collects at most `max_rows` results (0 for all) as
+// `Cursor.execute` does. `cache` may be NULL. Returns None, or NULL with an
+// exception set.
+PyObject *cursor_run_encoded(CursorObject *cursor, const char *query,
+                             mg_map *params, Py_ssize_t max_rows,
+                             DescriptionCache *cache);
+
 #endif
@@ -95,6 +95,42 @@ PyObject* INTERNAL_PyDateTime_DATE_GET_TZINFO(PyObject *obj)
 
 void py_datetime_import_init() { PyDateTime_IMPORT; }
 
+// `collections.abc.Mapping` and `collections.abc.Sequence`, used to accept
+// arbitrary containers as query parameters.
+static PyObject *abc_mapping = NULL;
+static PyObject *abc_sequence = NULL;
+
+int py_collections_abc_import_init() {
+  PyObject *module = PyImport_ImportModule("collections.abc");
+  if (!module) {
+    return -1;
+  }
+  abc_mapping = PyObject_GetAttrString(module, "Mapping");
+  abc_sequence = PyObject_GetAttrString(module, "Sequence");
+  Py_DECREF(module);
+  if (!abc_mapping || !abc_sequence) {
+    Py_CLEAR(abc_mapping);
+    Py_CLEAR(abc_sequence);
+    return -1;
+  }
+  return 0;
+}
+
+// Return -1 on failure
+// Return 0 or 1 for the outcome of the isinstance() check
+static int is_abc_mapping(PyObject *obj) {
+  return PyObject_IsInstance(obj, abc_mapping);
+}
+
+// Byte strings are sequences too, but have no Memgraph counterpart and must
+// not be silently turned into lists of integers.
+static int is_abc_sequence(PyObject *obj) {
+  if (PyBytes_Check(obj) || PyByteArray_Check(obj)) {
+    return 0;
+  }
+  return PyObject_IsInstance(obj, abc_sequence);
+}
+
 PyObject *mg_list_to_py_tuple(const mg_list *list) {
   PyObject *tuple = PyTuple_New(mg_list_size(list));
   if (!tuple) {
@@ -573,6 +609,81 @@ PyObject *mg_value_to_py_object(const mg_value *value) {
   }
 }
 
+// Approximate PackStream size of a value as received from the server: a small
+// header per value plus the payload of strings and containers. Cheap enough to
+// compute for every received record.
+static size_t mg_value_encoded_size(const mg_value *value) {
+  switch (mg_value_get_type(value)) {
+    case MG_VALUE_TYPE_NULL:
+    case MG_VALUE_TYPE_BOOL:
+      return 1;
+    case MG_VALUE_TYPE_INTEGER:
+    case MG_VALUE_TYPE_FLOAT:
+      return 9;
+    case MG_VALUE_TYPE_STRING:
+      return 5 + mg_string_size(mg_value_string(value));
+    case MG_VALUE_TYPE_LIST:
+      return mg_list_encoded_size(mg_value_list(value));
+    case MG_VALUE_TYPE_MAP:
+      return mg_map_encoded_size(mg_value_map(value));
+    case MG_VALUE_TYPE_NODE: {
+      const mg_node *node = mg_value_node(value);
+      size_t size = 2 + 9 + 5;
+      for (uint32_t i = 0; i < mg_node_label_count(node); ++i) {
+        size += 5 + mg_string_size(mg_node_label_at(node, i));
+      }
+      return size + mg_map_encoded_size(mg_node_properties(node));
+    }
+    case MG_VALUE_TYPE_RELATIONSHIP: {
+      const mg_relationship *rel = mg_value_relationship(value);
+      return 2 + 3 * 9 + 5 + mg_string_size(mg_relationship_type(rel)) +
+             mg_map_encoded_size(mg_relationship_properties(rel));
+    }
+    case MG_VALUE_TYPE_UNBOUND_RELATIONSHIP: {
+      const mg_unbound_relationship *rel = mg_value_unbound_relationship(value);
+      return 2 + 9 + 5 + mg_string_size(mg_unbound_relationship_type(rel)) +
+             mg_map_encoded_size(mg_unbound_relationship_properties(rel));
+    }
+    case MG_VALUE_TYPE_PATH: {
+      const mg_path *path = mg_value_path(value);
+      size_t size = 2 + 3 * 5 + 9 * (size_t)mg_path_length(path);
+      for (uint32_t i = 0; i <= mg_path_length(path); ++i) {
+        const mg_node *node = mg_path_node_at(path, i);
+        size += 2 + 9 + 5 + mg_map_encoded_size(mg_node_properties(node));
+        for (uint32_t j = 0; j < mg_node_label_count(node); ++j) {
+          size += 5 + mg_string_size(mg_node_label_at(node, j));
+        }
+      }
+      for (uint32_t i = 0; i < mg_path_length(path); ++i) {
+        const mg_unbound_relationship *rel = mg_path_relationship_at(path, i);
+        size += 2 + 9 + 5 + mg_string_size(mg_unbound_relationship_type(rel)) +
+                mg_map_encoded_size(mg_unbound_relationship_properties(rel));
+      }
+      return size;
+    }
+    default:
+      // Temporal types: a struct with at most three integers.
+      return 2 + 3 * 9;
+  }
+}
+
+size_t mg_list_encoded_size(const mg_list *list) {
+  size_t size = 5;
+  for (uint32_t i = 0; i < mg_list_size(list); ++i) {
+    size += mg_value_encoded_size(mg_list_at(list, i));
+  }
+  return size;
+}
+
+size_t mg_map_encoded_size(const mg_map *map) {
+  size_t size = 5;
+  for (uint32_t i = 0; i < mg_map_size(map); ++i) {
+    size += 5 + mg_string_size(mg_map_key_at(map, i)) +
+            mg_value_encoded_size(mg_map_value_at(map, i));
+  }
+  return size;
+}
+
 mg_string *py_unicode_to_mg_string(PyObject *unicode) {
   assert(PyUnicode_Check(unicode));
   Py_ssize_t size;
@@ -592,26 +703,35 @@ mg_string *py_unicode_to_mg_string(PyObject *unicode) {
   return ret;
 }
 
-mg_list *py_list_to_mg_list(PyObject *pylist) {
-  assert(PyList_Check(pylist));
+// Encodes a list or a tuple, reading the items in place through the fast
+// sequence API.
+mg_list *py_sequence_to_mg_list(PyObject *seq) {
+  assert(PyList_Check(seq) || PyTuple_Check(seq));
 
   mg_list *list = NULL;
+  const Py_ssize_t size = PySequence_Fast_GET_SIZE(seq);
 
-  if (PyList_Size(pylist) > UINT32_MAX) {
+  if (size > UINT32_MAX) {
     PyErr_SetString(PyExc_ValueError, "list size exceeded");
     goto cleanup;
   }
 
-  list = mg_list_make_empty((uint32_t)PyList_Size(pylist));
+  list = mg_list_make_empty((uint32_t)size);
   if (!list) {
     PyErr_SetString(PyExc_RuntimeError, "failed to create a mg_list");
     goto cleanup;
   }
 
-  for (uint32_t i = 0; i < (uint32_t)PyList_Size(pylist); ++i) {
-    mg_value *elem = py_object_to_mg_value(PyList_GetItem(pylist, i));
+  // Converting an item may run Python code (e.g. a tzinfo's __str__) which
+  // could shrink a list under us, so the size is re-checked on every step and
+  // the item is kept alive while it's being converted.
+  for (Py_ssize_t i = 0; i < size && i < PySequence_Fast_GET_SIZE(seq); ++i) {
+    PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+    Py_INCREF(item);
+    mg_value *elem = py_object_to_mg_value(item);
+    Py_DECREF(item);
     if (!elem) {
-      return NULL;
+      goto cleanup;
     }
     if (mg_list_append(list, elem) != 0) {
       abort();
@@ -625,6 +745,82 @@ cleanup:
   return NULL;
 }
 
+// Encodes the remaining items of an iterator into a mg_list. Items are
+// converted as soon as the iterator produces them and only the resulting
+// mg_values are kept, in a buffer that grows in chunks, so a generator feeding
+// a huge batch never has to exist as a Python list.
+mg_list *py_iter_to_mg_list(PyObject *iter) {
+  assert(PyIter_Check(iter));
+
+  mg_value **values = NULL;
+  mg_list *list = NULL;
+  Py_ssize_t size = 0;
+  Py_ssize_t capacity = PyObject_LengthHint(iter, 1024);
+  if (capacity < 0) {
+    return NULL;
+  }
+  if (capacity == 0) {
+    capacity = 1;
+  }
+  if (!(values = PyMem_New(mg_value *, capacity))) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+
+  PyObject *item;
+  while ((item = PyIter_Next(iter))) {
+    mg_value *elem = py_object_to_mg_value(item);
+    Py_DECREF(item);
+    if (!elem) {
+      goto cleanup;
+    }
+    if (size == capacity) {
+      if (capacity > UINT32_MAX / 2) {
+        mg_value_destroy(elem);
+        PyErr_SetString(PyExc_ValueError, "list size exceeded");
+        goto cleanup;
+      }
+      mg_value **grown =
+          PyMem_Realloc(values, 2 * capacity * sizeof(mg_value *));
+      if (!grown) {
+        mg_value_destroy(elem);
+        PyErr_NoMemory();
+        goto cleanup;
+      }
+      values = grown;
+      capacity *= 2;
+    }
+    values[size++] = elem;
+  }
+  if (PyErr_Occurred()) {
+    goto cleanup;
+  }
+  if (size > UINT32_MAX) {
+    PyErr_SetString(PyExc_ValueError, "list size exceeded");
+    goto cleanup;
+  }
+
+  list = mg_list_make_empty((uint32_t)size);
+  if (!list) {
+    PyErr_SetString(PyExc_RuntimeError, "failed to create a mg_list");
+    goto cleanup;
+  }
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    if (mg_list_append(list, values[i]) != 0) {
+      abort();
+    }
+  }
+  PyMem_Free(values);
+  return list;
+
+cleanup:
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    mg_value_destroy(values[i]);
+  }
+  PyMem_Free(values);
+  return NULL;
+}
+
 mg_map *py_dict_to_mg_map(PyObject *dict) {
   assert(PyDict_Check(dict));
 
@@ -672,23 +868,108 @@ cleanup:
   return NULL;
 }
 
-// Return 0 on failure
-// Return 1 on success
-int days_since_unix_epoch(int y, int m, int d, int64_t *result) {
-  SCOPED_CLEANUP PyObject *unix_epoch =
-      make_py_datetime(1970, 1, 1, 0, 0, 0, 0);
-  IF_PTR_IS_NULL_RETURN(unix_epoch, 0);
-  SCOPED_CLEANUP PyObject *date = make_py_datetime(y, m, d, 0, 0, 0, 0);
-  IF_PTR_IS_NULL_RETURN(date, 0);
-  SCOPED_CLEANUP PyObject *method_name = PyUnicode_FromString("__sub__");
-  IF_PTR_IS_NULL_RETURN(method_name, 0);
-  SCOPED_CLEANUP PyObject *delta =
-      PyObject_CallMethodObjArgs(date, method_name, unix_epoch, NULL);
-  IF_PTR_IS_NULL_RETURN(delta, 0);
-  SCOPED_CLEANUP PyObject *days = PyObject_GetAttrString(delta, "days");
-  IF_PTR_IS_NULL_RETURN(days, 0);
-  *result = PyLong_AsLong(days);
-  return 1;
+// Encodes any `collections.abc.Mapping` through the iteration protocol, without
+// first copying it into a dict.
+static mg_map *py_abc_mapping_to_mg_map(PyObject *mapping) {
+  mg_map *map = NULL;
+  PyObject *keys = NULL;
+
+  Py_ssize_t size = PyObject_Size(mapping);
+  if (size < 0) {
+    goto cleanup;
+  }
+  if (size > UINT32_MAX) {
+    PyErr_SetString(PyExc_ValueError, "dictionary size exceeded");
+    goto cleanup;
+  }
+
+  map = mg_map_make_empty((uint32_t)size);
+  if (!map) {
+    PyErr_SetString(PyExc_RuntimeError, "failed to create a mg_map");
+    goto cleanup;
+  }
+
+  if (!(keys = PyObject_GetIter(mapping))) {
+    goto cleanup;
+  }
+
+  Py_ssize_t count = 0;
+  PyObject *pykey;
+  while ((pykey = PyIter_Next(keys))) {
+    if (!PyUnicode_Check(pykey)) {
+      Py_DECREF(pykey);
+      PyErr_SetString(PyExc_ValueError, "dictionary key must be a string");
+      goto cleanup;
+    }
+    if (count++ == size) {
+      Py_DECREF(pykey);
+      PyErr_SetString(PyExc_RuntimeError,
+                      "mapping changed size during iteration");
+      goto cleanup;
+    }
+
+    PyObject *pyvalue = PyObject_GetItem(mapping, pykey);
+    if (!pyvalue) {
+      Py_DECREF(pykey);
+      goto cleanup;
+    }
+    mg_string *key = py_unicode_to_mg_string(pykey);
+    Py_DECREF(pykey);
+    if (!key) {
+      Py_DECREF(pyvalue);
+      goto cleanup;
+    }
+    mg_value *value = py_object_to_mg_value(pyvalue);
+    Py_DECREF(pyvalue);
+    if (!value) {
+      mg_string_destroy(key);
+      goto cleanup;
+    }
+
+    if (mg_map_insert_unsafe2(map, key, value) != 0) {
+      abort();
+    }
+  }
+  if (PyErr_Occurred()) {
+    goto cleanup;
+  }
+
+  Py_DECREF(keys);
+  return map;
+
+cleanup:
+  Py_XDECREF(keys);
+  mg_map_destroy(map);
+  return NULL;
+}
+
+mg_map *py_mapping_to_mg_map(PyObject *mapping) {
+  if (PyDict_Check(mapping)) {
+    return py_dict_to_mg_map(mapping);
+  }
+  int is_mapping = is_abc_mapping(mapping);
+  if (is_mapping < 0) {
+    return NULL;
+  }
+  if (!is_mapping) {
+    PyErr_Format(PyExc_TypeError,
+                 "query parameters must be a mapping, not '%s'",
+                 Py_TYPE(mapping)->tp_name);
+    return NULL;
+  }
+  return py_abc_mapping_to_mg_map(mapping);
+}
+
+// Number of days from 1970-01-01 to the given proleptic Gregorian date. This
+// is the `days_from_civil` algorithm by Howard Hinnant; it is exact for every
+// date `datetime` can represent and needs no Python objects.
+int64_t days_since_unix_epoch(int y, int m, int d) {
+  const int64_t year = (int64_t)y - (m <= 2);
+  const int64_t era = (year >= 0 ? year : year - 399) / 400;
+  const int64_t yoe = year - era * 400;
+  const int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
 }
 
 int64_t microseconds_to_nanos(int64_t microseconds) {
@@ -722,21 +1003,15 @@ int64_t to_seconds(int64_t days, int hours, int minutes, int seconds) {
          seconds;
 }
 
-// Return 0 on failure
-// Return 1 on success
-int seconds_since_unix_epoch(PyObject *obj, int64_t *result) {
-  int y = PyDateTime_GET_YEAR(obj);
-  int mo = PyDateTime_GET_MONTH(obj);
-  int d = PyDateTime_GET_DAY(obj);
-  int64_t days = 0;
-  if (days_since_unix_epoch(y, mo, d, &days) == 0) {
-    return 0;
-  }
-  int h = PyDateTime_DATE_GET_HOUR(obj);
-  int m = PyDateTime_DATE_GET_MINUTE(obj);
-  int s = PyDateTime_DATE_GET_SECOND(obj);
-  *result = to_seconds(days, h, m, s);
-  return 1;
+// Wall-clock seconds since the Unix epoch of a `datetime`, ignoring its
+// `tzinfo`.
+int64_t seconds_since_unix_epoch(PyObject *obj) {
+  int64_t days =
+      days_since_unix_epoch(PyDateTime_GET_YEAR(obj), PyDateTime_GET_MONTH(obj),
+                            PyDateTime_GET_DAY(obj));
+  return to_seconds(days, PyDateTime_DATE_GET_HOUR(obj),
+                    PyDateTime_DATE_GET_MINUTE(obj),
+                    PyDateTime_DATE_GET_SECOND(obj));
 }
 
 int64_t subseconds_as_nanoseconds(PyObject *obj) {
@@ -744,14 +1019,9 @@ int64_t subseconds_as_nanoseconds(PyObject *obj) {
 }
 
 mg_date *py_date_to_mg_date(PyObject *obj) {
-  int y = PyDateTime_GET_YEAR(obj);
-  int m = PyDateTime_GET_MONTH(obj);
-  int d = PyDateTime_GET_DAY(obj);
-  int64_t days = 0;
-  if (!days_since_unix_epoch(y, m, d, &days)) {
-    return NULL;
-  }
-  return mg_date_make(days);
+  return mg_date_make(days_since_unix_epoch(PyDateTime_GET_YEAR(obj),
+                                            PyDateTime_GET_MONTH(obj),
+                                            PyDateTime_GET_DAY(obj)));
 }
 
 mg_local_time *py_time_to_mg_local_time(PyObject *obj) {
@@ -759,77 +1029,110 @@ mg_local_time *py_time_to_mg_local_time(PyObject *obj) {
 }
 
 mg_local_date_time *py_date_time_to_mg_local_date_time(PyObject *obj) {
-  int64_t seconds_since_epoch = 0;
-  if (seconds_since_unix_epoch(obj, &seconds_since_epoch) == 0) {
-    return NULL;
+  return mg_local_date_time_make(seconds_since_unix_epoch(obj),
+                                 subseconds_as_nanoseconds(obj));
+}
+
+// Resolving a `tzinfo` to an offset or a name means calling back into Python.
+// Bulk inserts usually stamp every row with the same `tzinfo` object, so the
+// result for the most recently seen one is remembered. The cache holds a
+// strong reference to its key, which therefore can't be freed and have its
+// address reused by a different object.
+static struct {
+  PyObject *tzinfo;
+  int32_t offset_minutes;
+} offset_cache = {NULL, 0};
+
+static struct {
+  PyObject *tzinfo;
+  PyObject *name;
+} zone_name_cache = {NULL, NULL};
+
+// `datetime.timezone` can't be subclassed, so comparing against the type of
+// the UTC singleton is an exact instance check.
+int is_datetime_timezone(PyObject *tzinfo) {
+  return tzinfo != Py_None &&
+         Py_TYPE(tzinfo) == Py_TYPE(PyDateTime_TimeZone_UTC);
+}
+
+// Return 0 on failure
+// Return 1 on success
+static int fixed_offset_minutes(PyObject *tzinfo, PyObject *obj,
+                                int32_t *result) {
+  assert(is_datetime_timezone(tzinfo));
+  if (offset_cache.tzinfo == tzinfo) {
+    *result = offset_cache.offset_minutes;
+    return 1;
   }
-  int64_t subseconds = subseconds_as_nanoseconds(obj);
-  return mg_local_date_time_make(seconds_since_epoch, subseconds);
+
+  SCOPED_CLEANUP PyObject *utc_offset =
+      PyObject_CallMethod(tzinfo, "utcoffset", "O", obj);
+  IF_PTR_IS_NULL_RETURN(utc_offset, 0);
+  if (!PyDelta_Check(utc_offset)) {
+    PyErr_SetString(PyExc_TypeError, "utcoffset() must return a timedelta");
+    return 0;
+  }
+  int64_t offset_seconds =
+      (int64_t)PyDateTime_DELTA_GET_DAYS(utc_offset) * 86400 +
+      PyDateTime_DELTA_GET_SECONDS(utc_offset);
+  // Offsets are whole minutes on the wire; truncate towards zero like the
+  // previous floating-point conversion did.
+  *result = (int32_t)(offset_seconds / 60);
+
+  Py_INCREF(tzinfo);
+  Py_XSETREF(offset_cache.tzinfo, tzinfo);
+  offset_cache.offset_minutes = *result;
+  return 1;
 }
 
-mg_date_time *py_date_time_to_mg_date_time(PyObject *obj) {
-  int64_t seconds_since_epoch = 0;
-  if (seconds_since_unix_epoch(obj, &seconds_since_epoch) == 0) {
-    return NULL;
+// Returns a borrowed reference to the `str()` name of `tzinfo`, valid until the
+// next call.
+static PyObject *zone_name(PyObject *tzinfo) {
+  if (zone_name_cache.tzinfo == tzinfo) {
+    return zone_name_cache.name;
   }
-  int64_t subseconds = subseconds_as_nanoseconds(obj);
 
+  PyObject *name = PyObject_Str(tzinfo);
+  IF_PTR_IS_NULL_RETURN(name, NULL);
+
+  Py_INCREF(tzinfo);
+  Py_XSETREF(zone_name_cache.tzinfo, tzinfo);
+  Py_XSETREF(zone_name_cache.name, name);
+  return name;
+}
+
+mg_date_time *py_date_time_to_mg_date_time(PyObject *obj) {
   PyObject *tzinfo = INTERNAL_PyDateTime_DATE_GET_TZINFO(obj);
   if (tzinfo == Py_None) {
     return NULL;
   }
 
-  SCOPED_CLEANUP PyObject *utc_offset = PyObject_CallMethod(tzinfo, "utcoffset", "O", obj);
-  IF_PTR_IS_NULL_RETURN(utc_offset, NULL);
-
-  SCOPED_CLEANUP PyObject *total_seconds = PyObject_CallMethod(utc_offset, "total_seconds", NULL);
-  IF_PTR_IS_NULL_RETURN(total_seconds, NULL);
-
-  double offset_seconds_double = PyFloat_AsDouble(total_seconds);
-  int32_t offset_minutes = (int32_t)(offset_seconds_double / 60.0);
+  int32_t offset_minutes = 0;
+  if (!fixed_offset_minutes(tzinfo, obj, &offset_minutes)) {
+    return NULL;
+  }
 
-  return mg_date_time_make(seconds_since_epoch, subseconds, offset_minutes);
+  return mg_date_time_make(seconds_since_unix_epoch(obj),
+                           subseconds_as_nanoseconds(obj), offset_minutes);
 }
 
 mg_date_time_zone_id *py_date_time_to_mg_date_time_zone_id(PyObject *obj) {
-  int64_t seconds_since_epoch = 0;
-  if (seconds_since_unix_epoch(obj, &seconds_since_epoch) == 0) {
-    return NULL;
-  }
-  int64_t subseconds = subseconds_as_nanoseconds(obj);
-
   PyObject *tzinfo = INTERNAL_PyDateTime_DATE_GET_TZINFO(obj);
   if (tzinfo == Py_None) {
     return NULL;
   }
 
-  SCOPED_CLEANUP PyObject *tzname_str = PyObject_Str(tzinfo);
+  PyObject *tzname_str = zone_name(tzinfo);
   IF_PTR_IS_NULL_RETURN(tzname_str, NULL);
 
-  if (!PyUnicode_Check(tzname_str)) {
-    return NULL;
-  }
-
   const char *timezone_name_str = PyUnicode_AsUTF8(tzname_str);
   if (!timezone_name_str) {
     return NULL;
   }
 
-  return mg_date_time_zone_id_make(seconds_since_epoch, subseconds, timezone_name_str);
-}
-
-int is_datetime_timezone(PyObject *tzinfo) {
-  if (tzinfo == Py_None) {
-    return 0;
-  }
-
-  SCOPED_CLEANUP PyObject *datetime_module = PyImport_ImportModule("datetime");
-  IF_PTR_IS_NULL_RETURN(datetime_module, 0);
-
-  SCOPED_CLEANUP PyObject *timezone_class = PyObject_GetAttrString(datetime_module, "timezone");
-  IF_PTR_IS_NULL_RETURN(timezone_class, 0);
-
-  return PyObject_IsInstance(tzinfo, timezone_class);
+  return mg_date_time_zone_id_make(seconds_since_unix_epoch(obj),
+                                   subseconds_as_nanoseconds(obj),
+                                   timezone_name_str);
 }
 
 mg_duration *py_delta_to_mg_duration(PyObject *obj) {
@@ -839,6 +1142,57 @@ mg_duration *py_delta_to_mg_duration(PyObject *obj) {
   return mg_duration_make(0, days, seconds, microseconds * 1000);
 }
 
+// Encodes the containers that don't have a dedicated fast path: sets, any
+// `collections.abc.Sequence` or `collections.abc.Mapping`, and iterators.
+static mg_value *py_container_to_mg_value(PyObject *object) {
+  int is_sequence = PyAnySet_Check(object) ? 1 : is_abc_sequence(object);
+  if (is_sequence < 0) {
+    return NULL;
+  }
+  int is_mapping = is_sequence ? 0 : is_abc_mapping(object);
+  if (is_mapping < 0) {
+    return NULL;
+  }
+
+  mg_value *ret = NULL;
+  if (is_sequence) {
+    PyObject *iter = PyObject_GetIter(object);
+    if (!iter) {
+      return NULL;
+    }
+    mg_list *list = py_iter_to_mg_list(iter);
+    Py_DECREF(iter);
+    if (!list) {
+      return NULL;
+    }
+    ret = mg_value_make_list(list);
+  } else if (is_mapping) {
+    mg_map *map = py_abc_mapping_to_mg_map(object);
+    if (!map) {
+      return NULL;
+    }
+    ret = mg_value_make_map(map);
+  } else if (PyIter_Check(object)) {
+    mg_list *list = py_iter_to_mg_list(object);
+    if (!list) {
+      return NULL;
+    }
+    ret = mg_value_make_list(list);
+  } else {
+    PyErr_Format(PyExc_ValueError,
+                 "value of type '%s' can't be used as query parameter",
+                 Py_TYPE(object)->tp_name);
+    return NULL;
+  }
+
+  if (!ret) {
+    PyErr_SetString(PyExc_RuntimeError, "failed to create a mg_value");
+    return NULL;
+  }
+
+  return ret;
+}
+
 mg_value *py_object_to_mg_value(PyObject *object) {
   mg_value *ret = NULL;
 
@@ -864,8 +1218,8 @@ mg_value *py_object_to_mg_value(PyObject *object) {
       return NULL;
     }
     ret = mg_value_make_string2(str);
-  } else if (PyList_Check(object)) {
-    mg_list *list = py_list_to_mg_list(object);
+  } else if (PyList_Check(object) || PyTuple_Check(object)) {
+    mg_list *list = py_sequence_to_mg_list(object);
     if (!list) {
       return NULL;
     }
@@ -922,10 +1276,7 @@ mg_value *py_object_to_mg_value(PyObject *object) {
     }
     ret = mg_value_make_duration(dur);
   } else {
-    PyErr_Format(PyExc_ValueError,
-                 "value of type '%s' can't be used as query parameter",
-                 Py_TYPE(object)->tp_name);
-    return NULL;
+    return py_container_to_mg_value(object);
   }
 
   if (!ret) {
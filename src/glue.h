@@ -27,11 +27,21 @@ PyObject *mg_value_to_py_object(const mg_value *value);
 
 PyObject *mg_map_to_py_dict(const mg_map *map);
 
+// Approximate PackStream-encoded size of a list, e.g. a received record.
+size_t mg_list_encoded_size(const mg_list *list);
+
+size_t mg_map_encoded_size(const mg_map *map);
+
 mg_map *py_dict_to_mg_map(PyObject *dict);
 
+// Like `py_dict_to_mg_map`, but also accepts any `collections.abc.Mapping`.
+mg_map *py_mapping_to_mg_map(PyObject *mapping);
+
 mg_value *py_object_to_mg_value(PyObject *object);
 
 mg_date_time_zone_id *py_date_time_to_mg_date_time_zone_id(PyObject *obj);
 
 void py_datetime_import_init();
+
+int py_collections_abc_import_init();
 #endif
@@ -26,7 +26,12 @@
 #include "connection.h"
 #include "cursor.h"
 #include "glue.h"
+#include "pool.h"
+#include "prepared.h"
+#include "querystats.h"
 #include "router.h"
+#include "summary.h"
+#include "trace.h"
 #include "types.h"
 
 PyObject *Warning;
@@ -177,6 +182,9 @@ static struct {
 } type_table[] = {{"Connection", &ConnectionType},
                   {"Cursor", &CursorType},
                   {"Column", &ColumnType},
+                  {"PreparedQuery", &PreparedQueryType},
+                  {"ResultSummary", &ResultSummaryType},
+                  {"ConnectionPool", &ConnectionPoolType},
                   {"Node", &NodeType},
                   {"Relationship", &RelationshipType},
                   {"Path", &PathType},
@@ -285,9 +293,118 @@ Currently recognized parameters are:\n\
         If this is set to ``True``, a lazy connection is made. Default is ``False``.");
 // clang-format on
 
+static PyObject *mgclient_enable_query_stats(PyObject *self, PyObject *args,
+                                             PyObject *kwargs) {
+  // Unused parameter.
+  (void)self;
+
+  static char *kwlist[] = {"enabled", NULL};
+  int enabled = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", kwlist, &enabled)) {
+    return NULL;
+  }
+  query_stats_set_enabled(enabled);
+  Py_RETURN_NONE;
+}
+
+// clang-format off
+PyDoc_STRVAR(mgclient_enable_query_stats_doc,
+"enable_query_stats(enabled=True)\n\
+--\n\
+\n\
+Starts (or with ``enabled=False`` stops) collecting the statistics returned by\n\
+:func:`query_stats` for the queries executed by all connections. Collection\n\
+is disabled by default.\n\
+\n\
+This also turns on the ``bytes_sent`` and ``bytes_received`` counters of\n\
+:attr:`Connection.stats`.");
+// clang-format on
+
+static PyObject *mgclient_query_stats(PyObject *self, PyObject *args,
+                                      PyObject *kwargs) {
+  // Unused parameter.
+  (void)self;
+
+  static char *kwlist[] = {"reset", NULL};
+  int reset = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", kwlist, &reset)) {
+    return NULL;
+  }
+  return query_stats_snapshot(reset);
+}
+
+// clang-format off
+PyDoc_STRVAR(mgclient_query_stats_doc,
+"query_stats(reset=False)\n\
+--\n\
+\n\
+Returns the statistics collected since :func:`enable_query_stats` was called\n\
+as a :class:`dict` mapping query fingerprints to dictionaries with keys:\n\
+\n\
+   * ``calls``: number of completed executions,\n\
+   * ``total_time`` and ``max_time``: total and longest time in seconds from\n\
+     :meth:`Cursor.execute` until the result was received completely,\n\
+   * ``rows``: number of rows received,\n\
+   * ``bytes``: approximate size of the rows received.\n\
+\n\
+A fingerprint is the query text with comments removed, whitespace collapsed\n\
+and string and numeric literals replaced by ``?``, so queries differing only\n\
+in inlined values are counted together.\n\
+\n\
+If ``reset`` is ``True``, the statistics are cleared after being read.");
+// clang-format on
+
+static PyObject *mgclient_set_trace_hook(PyObject *self, PyObject *hook) {
+  // Unused parameter.
+  (void)self;
+
+  if (hook != Py_None && !PyCallable_Check(hook)) {
+    PyErr_SetString(PyExc_TypeError, "trace hook must be callable or None");
+    return NULL;
+  }
+  PyObject *previous = trace_hook;
+  if (hook == Py_None) {
+    trace_hook = NULL;
+  } else {
+    Py_INCREF(hook);
+    trace_hook = hook;
+  }
+  Py_XDECREF(previous);
+  Py_RETURN_NONE;
+}
+
+// clang-format off
+PyDoc_STRVAR(mgclient_set_trace_hook_doc,
+"set_trace_hook(hook)\n\
+--\n\
+\n\
+Sets a callable invoked at the start and at the end of every query execution,\n\
+transaction begin, commit and rollback, and :class:`Router` managed\n\
+transaction, or removes it if ``hook`` is ``None``.\n\
+\n\
+The hook is called as ``hook(event, phase, info)``, where ``event`` is one of\n\
+``\"execute\"``, ``\"begin\"``, ``\"commit\"``, ``\"rollback\"``,\n\
+``\"execute_read\"`` and ``\"execute_write\"``, ``phase`` is ``\"start\"`` or\n\
+``\"end\"``, and ``info`` is a :class:`dict` with the ``query`` being executed\n\
+(or ``None``). At the end, ``info`` also holds the ``duration`` in seconds,\n\
+the number of ``rows`` received (``None`` if not known yet, as with lazy\n\
+connections) and the exception the operation failed with as ``error`` (or\n\
+``None``).\n\
+\n\
+Exceptions raised by the hook are reported with :func:`sys.unraisablehook`\n\
+and don't affect the traced operation. Without a hook set, tracing has no\n\
+measurable cost.");
+// clang-format on
+
 static PyMethodDef mgclient_methods[] = {
     {"connect", (PyCFunction)mgclient_connect, METH_VARARGS | METH_KEYWORDS,
      mgclient_connect_doc},
+    {"enable_query_stats", (PyCFunction)mgclient_enable_query_stats,
+     METH_VARARGS | METH_KEYWORDS, mgclient_enable_query_stats_doc},
+    {"query_stats", (PyCFunction)mgclient_query_stats,
+     METH_VARARGS | METH_KEYWORDS, mgclient_query_stats_doc},
+    {"set_trace_hook", (PyCFunction)mgclient_set_trace_hook, METH_O,
+     mgclient_set_trace_hook_doc},
     {NULL, NULL, 0, NULL}};
 
 static struct PyModuleDef mgclient_module = {.m_base = PyModuleDef_HEAD_INIT,
@@ -316,5 +433,8 @@ PyMODINIT_FUNC PyInit__mgclient(void) {
   }
 
   py_datetime_import_init();
+  if (py_collections_abc_import_init() < 0) {
+    return NULL;
+  }
   return m;
 }
@@ -0,0 +1,502 @@
+// Copyright (c) 2016-2020 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pool.h"
+
+#include <pythread.h>
+#include <structmember.h>
+
+#include "connection.h"
+#include "exceptions.h"
+#include "timings.h"
+
+typedef struct {
+  PyObject *conn;
+  // When the connection was released to the pool.
+  int64_t since;
+} PoolIdleConnection;
+
+// clang-format off
+typedef struct {
+  PyObject_HEAD
+
+  // Keyword arguments for `connect` used to open new connections.
+  PyObject *connect_kwargs;
+  Py_ssize_t min_size;
+  Py_ssize_t max_size;
+  // Seconds after which idle connections above `min_size` are closed, and
+  // after which an idle connection is checked before being handed out (0
+  // disables either).
+  double max_idle;
+  double health_check;
+  int closed;
+
+  // Idle connections, most recently released last. Has room for `max_size`.
+  PoolIdleConnection *idle;
+  Py_ssize_t nidle;
+  // Connections handed out and not released yet.
+  PyObject *in_use;
+  // Connections the pool is responsible for: idle, in use or being opened.
+  Py_ssize_t size;
+
+  // Threads blocked in `acquire` wait for `signal` to be released, which
+  // happens whenever a connection may have become available. All other state
+  // is protected by the GIL.
+  PyThread_type_lock signal;
+  int signalled;
+  Py_ssize_t waiters;
+} ConnectionPoolObject;
+// clang-format on
+
+// Wakes up one thread waiting for a connection, if there is any.
+static void pool_signal(ConnectionPoolObject *pool) {
+  if (pool->waiters > 0 && !pool->signalled) {
+    pool->signalled = 1;
+    PyThread_release_lock(pool->signal);
+  }
+}
+
+// Closes a connection the pool is done with.
+static void pool_discard(ConnectionPoolObject *pool, PyObject *conn) {
+  PyObject *result = PyObject_CallMethod(conn, "close", NULL);
+  if (result) {
+    Py_DECREF(result);
+  } else {
+    PyErr_Clear();
+  }
+  Py_DECREF(conn);
+  pool->size--;
+  pool_signal(pool);
+}
+
+// Closes the connections that have been idle for longer than `max_idle`,
+// leaving at least `min_size` open.
+static void pool_reap(ConnectionPoolObject *pool) {
+  if (pool->max_idle <= 0) {
+    return;
+  }
+  int64_t oldest = timings_now() - (int64_t)(pool->max_idle * 1e9);
+  Py_ssize_t expired = 0;
+  while (expired < pool->nidle && pool->size - expired > pool->min_size &&
+         pool->idle[expired].since < oldest) {
+    expired++;
+  }
+  if (!expired) {
+    return;
+  }
+  PoolIdleConnection *reaped = PyMem_Malloc(expired * sizeof(*reaped));
+  if (!reaped) {
+    return;
+  }
+  // Take them out of the pool before closing any, as closing can run Python
+  // code (trace hooks) that may use the pool.
+  memcpy(reaped, pool->idle, expired * sizeof(*reaped));
+  pool->nidle -= expired;
+  memmove(pool->idle, pool->idle + expired, pool->nidle * sizeof(*reaped));
+  for (Py_ssize_t i = 0; i < expired; ++i) {
+    pool_discard(pool, reaped[i].conn);
+  }
+  PyMem_Free(reaped);
+}
+
+// Opens a new connection on behalf of the pool. Returns a new reference, or
+// NULL with an exception set.
+static PyObject *pool_open(ConnectionPoolObject *pool) {
+  pool->size++;
+  PyObject *args = PyTuple_New(0);
+  PyObject *conn =
+      args ? PyObject_Call((PyObject *)&ConnectionType, args,
+                           pool->connect_kwargs)
+           : NULL;
+  Py_XDECREF(args);
+  if (!conn) {
+    pool->size--;
+    pool_signal(pool);
+  }
+  return conn;
+}
+
+// Takes an idle connection out of the pool, checking it first if it has been
+// idle for a while. Returns a new reference, or NULL if no idle connection is
+// usable.
+static PyObject *pool_take_idle(ConnectionPoolObject *pool) {
+  while (pool->nidle > 0) {
+    PoolIdleConnection *entry = &pool->idle[--pool->nidle];
+    PyObject *conn = entry->conn;
+    if (pool->health_check > 0 &&
+        timings_now() - entry->since >= (int64_t)(pool->health_check * 1e9) &&
+        connection_ping((ConnectionObject *)conn) < 0) {
+      PyErr_Clear();
+      pool_discard(pool, conn);
+      continue;
+    }
+    return conn;
+  }
+  return NULL;
+}
+
+// Waits until a connection may have become available or `deadline` (-1 for
+// none) passes. Returns 1 if signalled, 0 on timeout and -1 with an exception
+// set if interrupted.
+static int pool_wait(ConnectionPoolObject *pool, int64_t deadline) {
+  PY_TIMEOUT_T microseconds = -1;
+  if (deadline >= 0) {
+    int64_t remaining = deadline - timings_now();
+    if (remaining <= 0) {
+      return 0;
+    }
+    microseconds = remaining / 1000;
+    if (microseconds > PY_TIMEOUT_MAX) {
+      microseconds = PY_TIMEOUT_MAX;
+    }
+  }
+
+  PyLockStatus status;
+  pool->waiters++;
+  Py_BEGIN_ALLOW_THREADS;
+  status = PyThread_acquire_lock_timed(pool->signal, microseconds, 1);
+  Py_END_ALLOW_THREADS;
+  pool->waiters--;
+
+  if (status == PY_LOCK_ACQUIRED) {
+    pool->signalled = 0;
+    return 1;
+  }
+  if (status == PY_LOCK_INTR && PyErr_CheckSignals() < 0) {
+    return -1;
+  }
+  // Interrupted by a signal that didn't raise: check the pool again.
+  return status == PY_LOCK_INTR ? 1 : 0;
+}
+
+static int pool_init(ConnectionPoolObject *pool, PyObject *args,
+                     PyObject *kwargs) {
+  static char *kwlist[] = {"min_size", "max_size", "max_idle", "health_check",
+                           NULL};
+
+  // Everything besides the pool's own parameters is passed on to `connect`.
+  PyObject *connect_kwargs = kwargs ? PyDict_Copy(kwargs) : PyDict_New();
+  PyObject *pool_kwargs = PyDict_New();
+  if (!connect_kwargs || !pool_kwargs) {
+    goto cleanup;
+  }
+  for (char **key = kwlist; *key; ++key) {
+    PyObject *value = PyDict_GetItemString(connect_kwargs, *key);
+    if (value) {
+      if (PyDict_SetItemString(pool_kwargs, *key, value) < 0 ||
+          PyDict_DelItemString(connect_kwargs, *key) < 0) {
+        goto cleanup;
+      }
+    }
+  }
+
+  Py_ssize_t min_size = 0;
+  Py_ssize_t max_size = 10;
+  double max_idle = 600.0;
+  double health_check = 30.0;
+  if (!PyArg_ParseTupleAndKeywords(args, pool_kwargs, "|nn$dd", kwlist,
+                                   &min_size, &max_size, &max_idle,
+                                   &health_check)) {
+    goto cleanup;
+  }
+  if (max_size < 1 || min_size < 0 || min_size > max_size) {
+    PyErr_SetString(PyExc_ValueError,
+                    "pool sizes must satisfy 0 <= min_size <= max_size and "
+                    "max_size >= 1");
+    goto cleanup;
+  }
+  if (pool->signal || pool->idle) {
+    PyErr_SetString(InterfaceError, "connection pool already initialized");
+    goto cleanup;
+  }
+
+  if (!(pool->in_use = PySet_New(NULL))) {
+    goto cleanup;
+  }
+  if (!(pool->idle = PyMem_Calloc(max_size, sizeof(PoolIdleConnection)))) {
+    PyErr_NoMemory();
+    goto cleanup;
+  }
+  if (!(pool->signal = PyThread_allocate_lock())) {
+    PyErr_SetString(PyExc_RuntimeError, "couldn't allocate lock");
+    goto cleanup;
+  }
+  // The lock is held while not signalled.
+  PyThread_acquire_lock(pool->signal, WAIT_LOCK);
+
+  pool->connect_kwargs = connect_kwargs;
+  connect_kwargs = NULL;
+  pool->min_size = min_size;
+  pool->max_size = max_size;
+  pool->max_idle = max_idle;
+  pool->health_check = health_check;
+  pool->closed = 0;
+
+  while (pool->size < pool->min_size) {
+    PyObject *conn = pool_open(pool);
+    if (!conn) {
+      goto cleanup;
+    }
+    pool->idle[pool->nidle].conn = conn;
+    pool->idle[pool->nidle].since = timings_now();
+    pool->nidle++;
+  }
+
+  Py_DECREF(pool_kwargs);
+  return 0;
+
+cleanup:
+  Py_XDECREF(connect_kwargs);
+  Py_XDECREF(pool_kwargs);
+  return -1;
+}
+
+static PyObject *pool_new(PyTypeObject *subtype, PyObject *args,
+                          PyObject *kwargs) {
+  // Unused args.
+  (void)args;
+  (void)kwargs;
+
+  ConnectionPoolObject *pool =
+      (ConnectionPoolObject *)subtype->tp_alloc(subtype, 0);
+  if (!pool) {
+    return NULL;
+  }
+  pool->closed = 1;
+  return (PyObject *)pool;
+}
+
+static void pool_dealloc(ConnectionPoolObject *pool) {
+  for (Py_ssize_t i = 0; i < pool->nidle; ++i) {
+    Py_DECREF(pool->idle[i].conn);
+  }
+  PyMem_Free(pool->idle);
+  Py_XDECREF(pool->in_use);
+  Py_XDECREF(pool->connect_kwargs);
+  if (pool->signal) {
+    if (!pool->signalled) {
+      PyThread_release_lock(pool->signal);
+    }
+    PyThread_free_lock(pool->signal);
+  }
+  Py_TYPE(pool)->tp_free(pool);
+}
+
+// clang-format off
+PyDoc_STRVAR(pool_acquire_doc,
+"acquire(timeout=None)\n\
+--\n\
+\n\
+Return a :class:`Connection` from the pool, opening a new one if no idle\n\
+connection is available and the pool holds fewer than ``max_size``\n\
+connections.\n\
+\n\
+Otherwise, wait for another thread to release a connection, at most\n\
+``timeout`` seconds if given. An :exc:`OperationalError` is raised if no\n\
+connection becomes available in time.\n\
+\n\
+The connection must be handed back with :meth:`release` once it is no\n\
+longer needed.");
+// clang-format on
+
+static PyObject *pool_acquire(ConnectionPoolObject *pool, PyObject *args,
+                              PyObject *kwargs) {
+  static char *kwlist[] = {"timeout", NULL};
+  PyObject *pytimeout = Py_None;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &pytimeout)) {
+    return NULL;
+  }
+  int64_t deadline = -1;
+  if (pytimeout != Py_None) {
+    double timeout = PyFloat_AsDouble(pytimeout);
+    if (timeout == -1.0 && PyErr_Occurred()) {
+      return NULL;
+    }
+    if (timeout < 0) {
+      PyErr_SetString(PyExc_ValueError, "timeout must be non-negative");
+      return NULL;
+    }
+    deadline = timings_now() + (int64_t)(timeout * 1e9);
+  }
+
+  PyObject *conn = NULL;
+  while (!conn) {
+    if (pool->closed) {
+      pool_signal(pool);
+      PyErr_SetString(InterfaceError, "connection pool closed");
+      return NULL;
+    }
+    pool_reap(pool);
+    if (!(conn = pool_take_idle(pool)) && pool->size < pool->max_size) {
+      if (!(conn = pool_open(pool))) {
+        return NULL;
+      }
+    }
+    if (!conn) {
+      int status = pool_wait(pool, deadline);
+      if (status < 0) {
+        return NULL;
+      }
+      if (status == 0) {
+        PyErr_SetString(OperationalError,
+                        "timed out waiting for a connection from the pool");
+        return NULL;
+      }
+    }
+  }
+
+  if (PySet_Add(pool->in_use, conn) < 0) {
+    pool_discard(pool, conn);
+    return NULL;
+  }
+  // Another connection may be available for the next waiting thread.
+  if (pool->nidle > 0 || pool->size < pool->max_size) {
+    pool_signal(pool);
+  }
+  return conn;
+}
+
+// clang-format off
+PyDoc_STRVAR(pool_release_doc,
+"release(connection)\n\
+--\n\
+\n\
+Hand a connection obtained from :meth:`acquire` back to the pool.\n\
+\n\
+The result of a query that is still being received is discarded and the open\n\
+transaction, if any, is rolled back, so the next user of the connection gets\n\
+it in the state of a new one. Cursors of the connection must not be used\n\
+after it is released. Closed and broken connections are dropped from the\n\
+pool.");
+// clang-format on
+
+static PyObject *pool_release(ConnectionPoolObject *pool, PyObject *conn) {
+  int contains = pool->in_use ? PySet_Discard(pool->in_use, conn) : 0;
+  if (contains < 0) {
+    return NULL;
+  }
+  if (!contains) {
+    PyErr_SetString(PyExc_ValueError,
+                    "connection was not acquired from this pool");
+    return NULL;
+  }
+  // The reference held by `in_use` is now ours.
+  Py_INCREF(conn);
+
+  ConnectionObject *c = (ConnectionObject *)conn;
+  if (pool->closed || c->status == CONN_STATUS_BAD ||
+      c->status == CONN_STATUS_CLOSED) {
+    pool_discard(pool, conn);
+    Py_RETURN_NONE;
+  }
+  if (connection_reset(c) < 0) {
+    PyErr_Clear();
+    pool_discard(pool, conn);
+    Py_RETURN_NONE;
+  }
+
+  assert(pool->nidle < pool->max_size);
+  pool->idle[pool->nidle].conn = conn;
+  pool->idle[pool->nidle].since = timings_now();
+  pool->nidle++;
+  pool_signal(pool);
+  Py_RETURN_NONE;
+}
+
+// clang-format off
+PyDoc_STRVAR(pool_close_doc,
+"close()\n\
+--\n\
+\n\
+Close all idle connections and stop handing out new ones. Connections in use\n\
+are closed when they are released.");
+// clang-format on
+
+static PyObject *pool_close(ConnectionPoolObject *pool, PyObject *args) {
+  // Unused args.
+  (void)args;
+
+  pool->closed = 1;
+  while (pool->nidle > 0) {
+    pool_discard(pool, pool->idle[--pool->nidle].conn);
+  }
+  pool_signal(pool);
+  Py_RETURN_NONE;
+}
+
+static PyMethodDef pool_methods[] = {
+    {"acquire", (PyCFunction)pool_acquire, METH_VARARGS | METH_KEYWORDS,
+     pool_acquire_doc},
+    {"release", (PyCFunction)pool_release, METH_O, pool_release_doc},
+    {"close", (PyCFunction)pool_close, METH_NOARGS, pool_close_doc},
+    {NULL, NULL, 0, NULL}};
+
+static PyMemberDef pool_members[] = {
+    {"min_size", T_PYSSIZET, offsetof(ConnectionPoolObject, min_size),
+     READONLY, "The number of connections kept open even when idle."},
+    {"max_size", T_PYSSIZET, offsetof(ConnectionPoolObject, max_size),
+     READONLY, "The most connections the pool opens at the same time."},
+    {"size", T_PYSSIZET, offsetof(ConnectionPoolObject, size), READONLY,
+     "The number of open connections, idle or in use."},
+    {"idle", T_PYSSIZET, offsetof(ConnectionPoolObject, nidle), READONLY,
+     "The number of idle connections."},
+    {NULL}};
+
+// clang-format off
+PyDoc_STRVAR(ConnectionPoolType_doc,
+"ConnectionPool(min_size=0, max_size=10, *, max_idle=600.0, health_check=30.0, **kwargs)\n\
+--\n\
+\n\
+A thread-safe pool of connections, which saves opening a new connection\n\
+(and performing the handshake with the server) for each unit of work.\n\
+\n\
+All keyword arguments other than the ones below are passed to\n\
+:func:`connect` to open new connections.\n\
+\n\
+   * :obj:`min_size`\n\
+\n\
+        Number of connections opened right away and kept open while idle.\n\
+\n\
+   * :obj:`max_size`\n\
+\n\
+        The most connections open at the same time. Once all of them are in\n\
+        use, :meth:`acquire` waits for one to be released.\n\
+\n\
+   * :obj:`max_idle`\n\
+\n\
+        Seconds after which idle connections above ``min_size`` are closed\n\
+        (0 to keep them open).\n\
+\n\
+   * :obj:`health_check`\n\
+\n\
+        Seconds of being idle after which a connection is checked with a\n\
+        trivial query before being handed out (0 to never check). Connections\n\
+        failing the check are replaced with new ones.");
+// clang-format on
+
+// clang-format off
+PyTypeObject ConnectionPoolType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "mgclient.ConnectionPool",
+    .tp_doc = ConnectionPoolType_doc,
+    .tp_basicsize = sizeof(ConnectionPoolObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor)pool_dealloc,
+    .tp_methods = pool_methods,
+    .tp_members = pool_members,
+    .tp_init = (initproc)pool_init,
+    .tp_new = (newfunc)pool_new
+};
+// clang-format on
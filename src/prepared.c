@@ -0,0 +1,280 @@
+// Copyright (c) 2016-2026 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "prepared.h"
+
+#include <string.h>
+#include <structmember.h>
+
+#include "connection.h"
+#include "exceptions.h"
+#include "glue.h"
+
+static void prepared_clear_plan(PreparedQueryObject *pq) {
+  for (Py_ssize_t i = 0; i < pq->param_count; ++i) {
+    mg_string_destroy(pq->param_keys[i]);
+  }
+  PyMem_Free(pq->param_keys);
+  pq->param_keys = NULL;
+  pq->param_count = 0;
+  Py_CLEAR(pq->param_names);
+}
+
+static void prepared_dealloc(PreparedQueryObject *pq) {
+  Py_CLEAR(pq->cursor);
+  Py_CLEAR(pq->query);
+  Py_CLEAR(pq->encoded_query);
+  prepared_clear_plan(pq);
+  description_cache_clear(&pq->description_cache);
+  Py_TYPE(pq)->tp_free(pq);
+}
+
+static int prepared_init(PreparedQueryObject *pq, PyObject *args,
+                         PyObject *kwargs) {
+  ConnectionObject *conn = NULL;
+  PyObject *query = NULL;
+
+  static char *kwlist[] = {"", "", NULL};
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!U", kwlist,
+                                   &ConnectionType, &conn, &query)) {
+    return -1;
+  }
+
+  PyObject *encoded_query = PyUnicode_AsUTF8String(query);
+  if (!encoded_query) {
+    return -1;
+  }
+  if (strlen(PyBytes_AS_STRING(encoded_query)) !=
+      (size_t)PyBytes_GET_SIZE(encoded_query)) {
+    Py_DECREF(encoded_query);
+    PyErr_SetString(PyExc_ValueError, "embedded null character");
+    return -1;
+  }
+
+  PyObject *cursor =
+      PyObject_CallFunctionObjArgs((PyObject *)&CursorType, conn, NULL);
+  if (!cursor) {
+    Py_DECREF(encoded_query);
+    return -1;
+  }
+
+  // Replace any previous state (in case __init__ is called twice).
+  Py_XSETREF(pq->cursor, (CursorObject *)cursor);
+  Py_INCREF(query);
+  Py_XSETREF(pq->query, query);
+  Py_XSETREF(pq->encoded_query, encoded_query);
+  prepared_clear_plan(pq);
+  description_cache_clear(&pq->description_cache);
+  return 0;
+}
+
+// Remembers the keys of `params` as the plan for the following executes.
+static int prepared_update_plan(PreparedQueryObject *pq, const mg_map *params) {
+  prepared_clear_plan(pq);
+
+  const Py_ssize_t count = params ? mg_map_size(params) : 0;
+  PyObject *names = PyTuple_New(count);
+  mg_string **keys = PyMem_New(mg_string *, count ? count : 1);
+  if (!names || !keys) {
+    Py_XDECREF(names);
+    PyMem_Free(keys);
+    PyErr_NoMemory();
+    return -1;
+  }
+
+  Py_ssize_t built = 0;
+  for (; built < count; ++built) {
+    const mg_string *key = mg_map_key_at(params, (uint32_t)built);
+    PyObject *name =
+        PyUnicode_FromStringAndSize(mg_string_data(key), mg_string_size(key));
+    if (!name) {
+      goto failure;
+    }
+    PyUnicode_InternInPlace(&name);
+    PyTuple_SET_ITEM(names, built, name);
+    if (!(keys[built] = mg_string_copy(key))) {
+      PyErr_SetString(PyExc_RuntimeError, "failed to create a mg_string");
+      goto failure;
+    }
+  }
+
+  pq->param_names = names;
+  pq->param_keys = keys;
+  pq->param_count = count;
+  return 0;
+
+failure:
+  for (Py_ssize_t i = 0; i < built; ++i) {
+    mg_string_destroy(keys[i]);
+  }
+  PyMem_Free(keys);
+  Py_DECREF(names);
+  return -1;
+}
+
+// Encodes `params` following the plan. Returns 0 and sets `*out` (NULL for no
+// parameters) on success, 1 if `params` doesn't match the plan, and -1 with
+// an exception set on failure.
+static int prepared_encode_planned(PreparedQueryObject *pq, PyObject *params,
+                                   mg_map **out) {
+  if (!pq->param_names) {
+    return 1;
+  }
+  if (!params || params == Py_None) {
+    if (pq->param_count != 0) {
+      return 1;
+    }
+    *out = NULL;
+    return 0;
+  }
+  if (!PyDict_Check(params) ||
+      PyDict_GET_SIZE(params) != pq->param_count) {
+    return 1;
+  }
+
+  mg_map *map = mg_map_make_empty((uint32_t)pq->param_count);
+  if (!map) {
+    PyErr_SetString(PyExc_RuntimeError, "failed to create a mg_map");
+    return -1;
+  }
+  for (Py_ssize_t i = 0; i < pq->param_count; ++i) {
+    PyObject *pyvalue =
+        PyDict_GetItemWithError(params, PyTuple_GET_ITEM(pq->param_names, i));
+    if (!pyvalue) {
+      mg_map_destroy(map);
+      return PyErr_Occurred() ? -1 : 1;
+    }
+    mg_value *value = py_object_to_mg_value(pyvalue);
+    if (!value) {
+      mg_map_destroy(map);
+      return -1;
+    }
+    mg_string *key = mg_string_copy(pq->param_keys[i]);
+    if (!key) {
+      mg_value_destroy(value);
+      mg_map_destroy(map);
+      PyErr_SetString(PyExc_RuntimeError, "failed to create a mg_string");
+      return -1;
+    }
+    if (mg_map_insert_unsafe2(map, key, value) != 0) {
+      abort();
+    }
+  }
+  *out = map;
+  return 0;
+}
+
+// clang-format off
+PyDoc_STRVAR(prepared_execute_doc,
+"execute(params=None, *, max_rows=0)\n\
+--\n\
+\n\
+Execute the prepared query with the given parameters on :attr:`cursor` and\n\
+return that cursor, ready for fetching the results.\n\
+\n\
+Executing again discards the results of the previous execution, exactly like\n\
+calling :meth:`Cursor.execute` again would. ``max_rows`` limits the number of\n\
+rows kept as in :meth:`Cursor.execute`.");
+// clang-format on
+
+static PyObject *prepared_execute(PreparedQueryObject *pq, PyObject *args,
+                                  PyObject *kwargs) {
+  static char *kwlist[] = {"params", "max_rows", NULL};
+  PyObject *params = NULL;
+  Py_ssize_t max_rows = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O$n", kwlist, &params,
+                                   &max_rows)) {
+    return NULL;
+  }
+
+  if (!pq->cursor) {
+    PyErr_SetString(InterfaceError, "prepared query not initialized");
+    return NULL;
+  }
+
+  if (cursor_begin_execute(pq->cursor) < 0) {
+    return NULL;
+  }
+
+  mg_map *mg_params = NULL;
+  int planned = prepared_encode_planned(pq, params, &mg_params);
+  if (planned < 0) {
+    return NULL;
+  }
+  if (planned > 0) {
+    if (params && params != Py_None) {
+      if (!(mg_params = py_mapping_to_mg_map(params))) {
+        return NULL;
+      }
+    }
+    if (prepared_update_plan(pq, mg_params) < 0) {
+      mg_map_destroy(mg_params);
+      return NULL;
+    }
+  }
+
+  PyObject *result =
+      cursor_run_encoded(pq->cursor, PyBytes_AS_STRING(pq->encoded_query),
+                         mg_params, max_rows, &pq->description_cache);
+  if (!result) {
+    return NULL;
+  }
+  Py_DECREF(result);
+  Py_INCREF(pq->cursor);
+  return (PyObject *)pq->cursor;
+}
+
+static PyMethodDef prepared_methods[] = {
+    {"execute", (PyCFunction)prepared_execute, METH_VARARGS | METH_KEYWORDS,
+     prepared_execute_doc},
+    {NULL, NULL, 0, NULL}};
+
+PyDoc_STRVAR(PreparedQueryType_query_doc, "The text of the prepared query.");
+
+PyDoc_STRVAR(PreparedQueryType_cursor_doc,
+             "The :class:`Cursor` the prepared query is executed on.");
+
+static PyMemberDef prepared_members[] = {
+    {"query", T_OBJECT, offsetof(PreparedQueryObject, query), READONLY,
+     PreparedQueryType_query_doc},
+    {"cursor", T_OBJECT, offsetof(PreparedQueryObject, cursor), READONLY,
+     PreparedQueryType_cursor_doc},
+    {NULL}};
+
+// clang-format off
+PyDoc_STRVAR(PreparedQueryType_doc,
+"A query prepared for repeated execution.\n\
+\n\
+New instances are created by :meth:`Connection.prepare`. The query text is\n\
+encoded once, and the names of the parameters and the result columns of the\n\
+last execution are remembered, so executing the same query many times\n\
+skips most of the per-call work done by :meth:`Cursor.execute`.\n\
+\n\
+Prepared queries are not thread-safe.");
+// clang-format on
+
+// clang-format off
+PyTypeObject PreparedQueryType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "mgclient.PreparedQuery",
+    .tp_doc = PreparedQueryType_doc,
+    .tp_basicsize = sizeof(PreparedQueryObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor)prepared_dealloc,
+    .tp_methods = prepared_methods,
+    .tp_members = prepared_members,
+    .tp_init = (initproc)prepared_init,
+    .tp_new = PyType_GenericNew};
+// clang-format on
@@ -0,0 +1,46 @@
+// Copyright (c) 2016-2026 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PYMGCLIENT_PREPARED_H
+#define PYMGCLIENT_PREPARED_H
+
+#include <Python.h>
+
+#include <mgclient.h>
+
+#include "cursor.h"
+
+// clang-format off
+typedef struct {
+  PyObject_HEAD
+
+  CursorObject *cursor;
+  // The query text as given, and its UTF-8 encoding sent on every execute.
+  PyObject *query;
+  PyObject *encoded_query;
+
+  // The parameter plan: the names of the parameters passed on the last
+  // execute, both as Python strings (to look the values up) and as mg_strings
+  // (copied into the outgoing parameter map instead of re-encoding the names).
+  PyObject *param_names;
+  mg_string **param_keys;
+  Py_ssize_t param_count;
+
+  DescriptionCache description_cache;
+} PreparedQueryObject;
+// clang-format on
+
+extern PyTypeObject PreparedQueryType;
+
+#endif
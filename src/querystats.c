@@ -0,0 +1,304 @@
+// Copyright (c) 2016-2020 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "querystats.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#include "timings.h"
+
+// Most distinct fingerprints tracked. Executions of queries with further
+// fingerprints are not counted until the statistics are reset.
+#define QUERY_STATS_MAX_ENTRIES 5000
+// Most query texts remembered along with their fingerprint's entry, so that
+// repeated queries don't have to be normalized again.
+#define QUERY_STATS_MAX_TEXTS 1024
+
+typedef struct {
+  uint64_t calls;
+  // Nanoseconds.
+  int64_t total_time;
+  int64_t max_time;
+  uint64_t rows;
+  uint64_t bytes;
+} QueryStatsEntry;
+
+int query_stats_enabled = 0;
+// Changes on reset, so executions started before it are not recorded.
+static uint64_t generation = 0;
+static QueryStatsEntry *entries = NULL;
+static Py_ssize_t nentries = 0;
+static Py_ssize_t capacity = 0;
+// Fingerprint -> index in `entries`.
+static PyObject *slots = NULL;
+// Query text -> index in `entries`.
+static PyObject *texts = NULL;
+
+static int is_identifier_char(unsigned char c) {
+  return c == '_' || isalnum(c) || c >= 0x80;
+}
+
+static const char *skip_identifier(const char *p) {
+  while (*p && is_identifier_char((unsigned char)*p)) {
+    p++;
+  }
+  return p;
+}
+
+static const char *skip_number(const char *p) {
+  const char *start = p;
+  while (*p) {
+    if (is_identifier_char((unsigned char)*p)) {
+      p++;
+    } else if (*p == '.' && isdigit((unsigned char)p[1])) {
+      p++;
+    } else if ((*p == '+' || *p == '-') && p > start &&
+               (p[-1] == 'e' || p[-1] == 'E')) {
+      p++;
+    } else {
+      break;
+    }
+  }
+  return p;
+}
+
+PyObject *query_stats_fingerprint(const char *query) {
+  // The fingerprint is never longer than the query.
+  char *out = PyMem_Malloc(strlen(query) + 1);
+  if (!out) {
+    return PyErr_NoMemory();
+  }
+  size_t n = 0;
+  int space = 0;
+  const char *p = query;
+  while (*p) {
+    unsigned char c = (unsigned char)*p;
+    if (isspace(c)) {
+      space = 1;
+      p++;
+      continue;
+    }
+    if (c == '/' && p[1] == '/') {
+      while (*p && *p != '\n') {
+        p++;
+      }
+      space = 1;
+      continue;
+    }
+    if (c == '/' && p[1] == '*') {
+      const char *end = strstr(p + 2, "*/");
+      p = end ? end + 2 : p + strlen(p);
+      space = 1;
+      continue;
+    }
+    if (space && n > 0) {
+      out[n++] = ' ';
+    }
+    space = 0;
+
+    const char *end;
+    if (c == '\'' || c == '"') {
+      // String literal.
+      end = p + 1;
+      while (*end && *end != (char)c) {
+        end += (*end == '\\' && end[1]) ? 2 : 1;
+      }
+      p = *end ? end + 1 : end;
+      out[n++] = '?';
+      continue;
+    }
+    if (isdigit(c) || (c == '.' && isdigit((unsigned char)p[1]))) {
+      // Numeric literal.
+      p = skip_number(p + 1);
+      out[n++] = '?';
+      continue;
+    }
+    if (c == '`') {
+      // Escaped name, kept as is.
+      const char *close = strchr(p + 1, '`');
+      end = close ? close + 1 : p + strlen(p);
+    } else if (c == '$') {
+      // Parameter, kept as is.
+      end = skip_identifier(p + 1);
+    } else if (is_identifier_char(c)) {
+      end = skip_identifier(p);
+    } else {
+      end = p + 1;
+    }
+    memcpy(out + n, p, (size_t)(end - p));
+    n += (size_t)(end - p);
+    p = end;
+  }
+
+  PyObject *fingerprint = PyUnicode_DecodeUTF8(out, (Py_ssize_t)n, "replace");
+  PyMem_Free(out);
+  return fingerprint;
+}
+
+void query_stats_set_enabled(int value) { query_stats_enabled = value; }
+
+static void query_stats_reset(void) {
+  generation++;
+  nentries = 0;
+  if (slots) {
+    PyDict_Clear(slots);
+  }
+  if (texts) {
+    PyDict_Clear(texts);
+  }
+}
+
+// Returns the index in `entries` of the new or existing entry for the
+// fingerprint of `text`, or NULL if the query can't be tracked (possibly with
+// an exception set).
+static PyObject *query_stats_slot(PyObject *text, const char *query) {
+  PyObject *index = PyDict_GetItemWithError(texts, text);
+  if (index || PyErr_Occurred()) {
+    Py_XINCREF(index);
+    return index;
+  }
+
+  PyObject *fingerprint = query_stats_fingerprint(query);
+  if (!fingerprint) {
+    return NULL;
+  }
+  index = PyDict_GetItemWithError(slots, fingerprint);
+  if (index) {
+    Py_INCREF(index);
+  } else if (!PyErr_Occurred() && nentries < QUERY_STATS_MAX_ENTRIES) {
+    if (nentries == capacity) {
+      Py_ssize_t new_capacity = capacity ? capacity * 2 : 64;
+      if (new_capacity > QUERY_STATS_MAX_ENTRIES) {
+        new_capacity = QUERY_STATS_MAX_ENTRIES;
+      }
+      QueryStatsEntry *new_entries =
+          PyMem_Realloc(entries, new_capacity * sizeof(QueryStatsEntry));
+      if (!new_entries) {
+        Py_DECREF(fingerprint);
+        return PyErr_NoMemory();
+      }
+      entries = new_entries;
+      capacity = new_capacity;
+    }
+    if ((index = PyLong_FromSsize_t(nentries))) {
+      if (PyDict_SetItem(slots, fingerprint, index) < 0) {
+        Py_CLEAR(index);
+      } else {
+        memset(&entries[nentries], 0, sizeof(QueryStatsEntry));
+        nentries++;
+      }
+    }
+  }
+  Py_DECREF(fingerprint);
+  if (!index) {
+    return NULL;
+  }
+
+  if (PyDict_GET_SIZE(texts) >= QUERY_STATS_MAX_TEXTS) {
+    PyDict_Clear(texts);
+  }
+  if (PyDict_SetItem(texts, text, index) < 0) {
+    Py_DECREF(index);
+    return NULL;
+  }
+  return index;
+}
+
+void query_stats_begin(QueryStatsProbe *probe, const char *query,
+                       uint64_t rows, uint64_t bytes) {
+  probe->slot = -1;
+  if (!query_stats_enabled) {
+    return;
+  }
+  if (!slots && !(slots = PyDict_New())) {
+    PyErr_Clear();
+    return;
+  }
+  if (!texts && !(texts = PyDict_New())) {
+    PyErr_Clear();
+    return;
+  }
+
+  PyObject *text = PyUnicode_FromString(query);
+  if (!text) {
+    PyErr_Clear();
+    return;
+  }
+  PyObject *index = query_stats_slot(text, query);
+  Py_DECREF(text);
+  if (!index) {
+    PyErr_Clear();
+    return;
+  }
+  probe->slot = PyLong_AsSsize_t(index);
+  Py_DECREF(index);
+
+  probe->generation = generation;
+  probe->rows = rows;
+  probe->bytes = bytes;
+  probe->start = timings_now();
+}
+
+void query_stats_end(QueryStatsProbe *probe, uint64_t rows, uint64_t bytes) {
+  if (probe->slot < 0) {
+    return;
+  }
+  if (probe->generation == generation && probe->slot < nentries) {
+    int64_t elapsed = timings_now() - probe->start;
+    QueryStatsEntry *entry = &entries[probe->slot];
+    entry->calls++;
+    entry->total_time += elapsed;
+    if (elapsed > entry->max_time) {
+      entry->max_time = elapsed;
+    }
+    entry->rows += rows - probe->rows;
+    entry->bytes += bytes - probe->bytes;
+  }
+  probe->slot = -1;
+}
+
+PyObject *query_stats_snapshot(int reset) {
+  PyObject *result = PyDict_New();
+  if (!result) {
+    return NULL;
+  }
+  if (slots) {
+    PyObject *fingerprint;
+    PyObject *index;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(slots, &pos, &fingerprint, &index)) {
+      const QueryStatsEntry *entry = &entries[PyLong_AsSsize_t(index)];
+      // Not a single execution has completed yet.
+      if (!entry->calls) {
+        continue;
+      }
+      PyObject *item = Py_BuildValue(
+          "{s:K,s:d,s:d,s:K,s:K}", "calls", (unsigned long long)entry->calls,
+          "total_time", entry->total_time / 1e9, "max_time",
+          entry->max_time / 1e9, "rows", (unsigned long long)entry->rows,
+          "bytes", (unsigned long long)entry->bytes);
+      if (!item || PyDict_SetItem(result, fingerprint, item) < 0) {
+        Py_XDECREF(item);
+        Py_DECREF(result);
+        return NULL;
+      }
+      Py_DECREF(item);
+    }
+  }
+  if (reset) {
+    query_stats_reset();
+  }
+  return result;
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2016-2020 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PYMGCLIENT_QUERYSTATS_H
+#define PYMGCLIENT_QUERYSTATS_H
+
+#include <Python.h>
+
+#include <stdint.h>
+
+// Module-wide statistics of executed queries, grouped by their fingerprint:
+// the query text with comments and literals stripped and whitespace
+// collapsed, so that queries differing only in inlined values are counted
+// together. Collection is off until enabled with
+// `mgclient.enable_query_stats()`.
+
+// Tracks one execution from `Cursor.execute` until its result has been
+// received completely.
+typedef struct {
+  // Index of the fingerprint's entry, or -1 when not tracked.
+  Py_ssize_t slot;
+  uint64_t generation;
+  int64_t start;
+  // Connection row / byte counters when the query started.
+  uint64_t rows;
+  uint64_t bytes;
+} QueryStatsProbe;
+
+#define QUERY_STATS_PROBE_INIT \
+  { -1, 0, 0, 0, 0 }
+
+// Starts tracking `query` if collection is enabled. Never fails; a query that
+// can't be tracked is simply not counted.
+void query_stats_begin(QueryStatsProbe *probe, const char *query,
+                       uint64_t rows, uint64_t bytes);
+
+// Records a tracked execution whose result is complete and stops tracking it.
+void query_stats_end(QueryStatsProbe *probe, uint64_t rows, uint64_t bytes);
+
+// Returns the fingerprint of `query` as a new string, or NULL with an
+// exception set.
+PyObject *query_stats_fingerprint(const char *query);
+
+// Whether collection is enabled. This also turns on the byte counters of the
+// connections' stats, as sizing each record walks all of its values.
+extern int query_stats_enabled;
+
+void query_stats_set_enabled(int enabled);
+
+// Returns a dict mapping each fingerprint to a dict of its statistics, or NULL
+// with an exception set. With `reset`, also starts collecting from scratch.
+PyObject *query_stats_snapshot(int reset);
+
+#endif
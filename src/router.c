@@ -14,82 +14,184 @@
 
 #include "router.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <mgclient.h>
+#include <pythread.h>
 
 #include "connection.h"
 #include "exceptions.h"
 #include "glue.h"
+#include "timings.h"
+#include "trace.h"
+
+// Idle sessions to one data instance, kept for reuse by later connections and
+// managed transactions, and the load the router observed on the instance.
+typedef struct {
+  // The instance's advertised "host:port" address.
+  char *address;
+  // The idle sessions, most recently returned last, and when each was.
+  mg_session **sessions;
+  int64_t *idle_since;
+  Py_ssize_t nsessions;
+  // Moving average of the time the instance took to answer a query, in
+  // seconds, or -1 until one has been measured.
+  double latency;
+  // Sessions to the instance handed out and not returned yet.
+  Py_ssize_t in_flight;
+  // Circuit breaker: transport failures in a row, and until when the instance
+  // is skipped after too many (0 while it isn't). Once that has passed, one
+  // thread probes the instance, setting `probing`, before it is used again.
+  uint32_t failures;
+  int64_t open_until;
+  int probing;
+} RouterSessionPool;
+
+// Weight of a new sample in `RouterSessionPool.latency`.
+#define ROUTER_LATENCY_WEIGHT 0.2
+
+struct RouterObject;
+
+// A libmgclient routing engine, used to fetch routing tables. A Router has two:
+// the active one, whose routing table is in use, and a spare one into which
+// each refresh fetches a new table before the two are swapped.
+typedef struct {
+  mg_router *router;
+  struct RouterObject *owner;
+  // The most recent exception raised inside a resolver callback, stashed while
+  // control is down in libmgclient's C code and re-raised once the top-level
+  // call returns. Only the thread leading a refresh uses the spare engine, and
+  // nobody calls into the active one, so a per-engine slot is safe.
+  PyObject *exc_type;
+  PyObject *exc_value;
+  PyObject *exc_tb;
+} RouterEngine;
 
 // clang-format off
 typedef struct RouterObject {
   PyObject_HEAD
 
-  mg_router *router;
+  RouterEngine engines[2];
+  // Index of the active engine in `engines`.
+  int active;
+  // Whether a thread is fetching a routing table into the spare engine.
+  // Refreshes are single-flight: other threads that need a new table wait on
+  // `refresh_done`, which the fetching thread holds until it is finished, and
+  // share its result instead of sending their own ROUTE requests.
+  int refreshing;
+  PyThread_type_lock refresh_done;
+  // Held for the router's lifetime; retry backoffs wait on it with a timeout,
+  // which a signal can interrupt.
+  PyThread_type_lock backoff_timer;
+  // The exception the last refresh failed with (NULL if it succeeded), raised
+  // again in the threads that waited for it.
+  PyObject *refresh_error;
   // The Python address resolver (or NULL for the identity mapping). Borrowed by
-  // `router` as its resolver_data, so it must outlive `router`.
+  // the engines as their resolver_data, so it must outlive them.
   PyObject *resolver;
-  // The most recent exception raised inside a callback (resolver or work),
-  // stashed while control is down in libmgclient's C code and re-raised once
-  // the top-level call returns. Everything here runs single-threaded with the
-  // GIL held, so a per-router slot is safe.
-  PyObject *exc_type;
-  PyObject *exc_value;
-  PyObject *exc_tb;
+
+  // Parameters of the sessions to data instances, which the router opens
+  // itself; `mg_router` is only used to fetch the routing table.
+  char *username;
+  char *password;
+  char *client_name;
+  char *sslcert;
+  char *sslkey;
+  enum mg_sslmode sslmode;
+  // Number of threads connecting to a data instance without holding the GIL,
+  // whose session parameters point into the settings above.
+  Py_ssize_t connecting;
+
+  uint32_t max_retries;
+  double retry_backoff;
+  double retry_backoff_cap;
+  // Transport failures in a row that open an instance's circuit (0 to never
+  // open it), and for how many seconds it then stays open.
+  uint32_t failure_threshold;
+  double failure_cooldown;
+
+  // The active routing table's addresses as a (write, read, route) tuple of
+  // tuples of str, or NULL before the first fetch. A new tuple replaces it when
+  // a new table is swapped in, so threads can keep using the one they got.
+  PyObject *table;
+  // The active table's TTL in seconds.
+  int64_t table_ttl;
+  // When the cached routing table was fetched by this object (0 if never).
+  int64_t table_fetched;
+  // State of the random number generator used to pick READ addresses.
+  uint64_t random;
+
+  // Idle sessions and load by address, at most `max_idle_sessions` idle
+  // sessions per address. Sessions idle for longer than `max_idle` seconds are
+  // closed instead of being reused (0 keeps them).
+  RouterSessionPool *pools;
+  Py_ssize_t npools;
+  Py_ssize_t max_idle_sessions;
+  double max_idle;
 } RouterObject;
 // clang-format on
 
+// Indices of the roles in `RouterObject.table`.
+enum { TABLE_WRITE, TABLE_READ, TABLE_ROUTE };
+
 // -- callback exception stashing --------------------------------------------
 
-static void router_clear_stashed(RouterObject *self) {
-  Py_CLEAR(self->exc_type);
-  Py_CLEAR(self->exc_value);
-  Py_CLEAR(self->exc_tb);
+static void router_clear_stashed(RouterEngine *engine) {
+  Py_CLEAR(engine->exc_type);
+  Py_CLEAR(engine->exc_value);
+  Py_CLEAR(engine->exc_tb);
 }
 
-// Move the currently-set Python exception into the router's stash (clearing the
-// pending error so libmgclient's C code runs without one set).
-static void router_stash_exception(RouterObject *self) {
-  router_clear_stashed(self);
-  PyErr_Fetch(&self->exc_type, &self->exc_value, &self->exc_tb);
+// Move the currently-set Python exception into the engine's stash (clearing
+// the pending error so libmgclient's C code runs without one set).
+static void router_stash_exception(RouterEngine *engine) {
+  router_clear_stashed(engine);
+  PyErr_Fetch(&engine->exc_type, &engine->exc_value, &engine->exc_tb);
 }
 
-static int router_has_stashed(const RouterObject *self) {
-  return self->exc_type != NULL || self->exc_value != NULL;
+static int router_has_stashed(const RouterEngine *engine) {
+  return engine->exc_type != NULL || engine->exc_value != NULL;
 }
 
-// Raise a Python exception for a failed router operation that returned `status`.
-// A stashed callback exception takes precedence (it carries the real cause and
-// traceback); otherwise the router's own message is used, classified as
-// transient or not.
-static void router_raise(RouterObject *self, int status) {
-  if (router_has_stashed(self)) {
-    PyErr_Restore(self->exc_type, self->exc_value, self->exc_tb);
-    self->exc_type = self->exc_value = self->exc_tb = NULL;
+// Raise a Python exception for a failed engine operation that returned
+// `status`. A stashed callback exception takes precedence (it carries the real
+// cause and traceback); otherwise the engine's own message is used, classified
+// as transient or not.
+static void router_raise(RouterEngine *engine, int status) {
+  if (router_has_stashed(engine)) {
+    PyErr_Restore(engine->exc_type, engine->exc_value, engine->exc_tb);
+    engine->exc_type = engine->exc_value = engine->exc_tb = NULL;
     return;
   }
   PyObject *exc =
       mg_error_is_transient(status) ? TransientError : OperationalError;
-  PyErr_SetString(exc, mg_router_error(self->router));
+  PyErr_SetString(exc, mg_router_error(engine->router));
 }
 
 // -- resolver trampoline -----------------------------------------------------
 
 // Bridges libmgclient's `mg_resolver_fn` to the Python resolver callable, which
-// maps an advertised "host:port" to an iterable of "host:port" targets.
+// maps an advertised "host:port" to an iterable of "host:port" targets. May be
+// called without the GIL held, from a background refresh.
 static int router_resolver_trampoline(const char *advertised,
                                       mg_resolver_result *result, void *data) {
-  RouterObject *self = (RouterObject *)data;
+  RouterEngine *engine = (RouterEngine *)data;
+  PyGILState_STATE gil = PyGILState_Ensure();
 
-  PyObject *targets = PyObject_CallFunction(self->resolver, "s", advertised);
+  PyObject *targets =
+      PyObject_CallFunction(engine->owner->resolver, "s", advertised);
   if (!targets) {
-    router_stash_exception(self);
+    router_stash_exception(engine);
+    PyGILState_Release(gil);
     return MG_ERROR_CLIENT_ERROR;
   }
   PyObject *seq =
       PySequence_Fast(targets, "resolver must return an iterable of addresses");
   Py_DECREF(targets);
   if (!seq) {
-    router_stash_exception(self);
+    router_stash_exception(engine);
+    PyGILState_Release(gil);
     return MG_ERROR_CLIENT_ERROR;
   }
 
@@ -99,23 +201,801 @@ static int router_resolver_trampoline(const char *advertised,
     PyObject *item = PySequence_Fast_GET_ITEM(seq, i);  // borrowed
     const char *target = PyUnicode_AsUTF8(item);
     if (!target) {
-      router_stash_exception(self);
+      router_stash_exception(engine);
       rc = MG_ERROR_CLIENT_ERROR;
       break;
     }
     if (mg_resolver_result_add(result, target) != 0) {
       PyErr_NoMemory();
-      router_stash_exception(self);
+      router_stash_exception(engine);
       rc = MG_ERROR_OOM;
       break;
     }
   }
   Py_DECREF(seq);
+  PyGILState_Release(gil);
+  return rc;
+}
+
+// -- session pools -----------------------------------------------------------
+
+static char *router_strdup(const char *str) {
+  if (!str) {
+    return NULL;
+  }
+  size_t size = strlen(str) + 1;
+  char *copy = PyMem_Malloc(size);
+  if (copy) {
+    memcpy(copy, str, size);
+  }
+  return copy;
+}
+
+// Copies the addresses of `table` into a tuple laid out like
+// `RouterObject.table`. Returns NULL with an exception set on failure.
+static PyObject *routing_table_snapshot(const mg_routing_table *table) {
+  static const enum mg_routing_role roles[] = {
+      MG_ROUTING_ROLE_WRITE, MG_ROUTING_ROLE_READ, MG_ROUTING_ROLE_ROUTE};
+  PyObject *snapshot = PyTuple_New(3);
+  if (!snapshot) {
+    return NULL;
+  }
+  for (Py_ssize_t r = 0; r < 3; ++r) {
+    uint32_t count = mg_routing_table_address_count(table, roles[r]);
+    PyObject *addresses = PyTuple_New(count);
+    if (!addresses) {
+      Py_DECREF(snapshot);
+      return NULL;
+    }
+    PyTuple_SET_ITEM(snapshot, r, addresses);  // steals reference
+    for (uint32_t i = 0; i < count; ++i) {
+      PyObject *address =
+          PyUnicode_FromString(mg_routing_table_address_at(table, roles[r], i));
+      if (!address) {
+        Py_DECREF(snapshot);
+        return NULL;
+      }
+      PyTuple_SET_ITEM(addresses, i, address);  // steals reference
+    }
+  }
+  return snapshot;
+}
+
+// Whether `address` is listed in any role of `table` (a snapshot).
+static int routing_table_lists(PyObject *table, const char *address) {
+  for (Py_ssize_t r = 0; r < 3; ++r) {
+    PyObject *addresses = PyTuple_GET_ITEM(table, r);
+    for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(addresses); ++i) {
+      if (PyUnicode_CompareWithASCIIString(PyTuple_GET_ITEM(addresses, i),
+                                           address) == 0) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+static void router_pool_clear(RouterSessionPool *pool) {
+  for (Py_ssize_t i = 0; i < pool->nsessions; ++i) {
+    mg_session_destroy(pool->sessions[i]);
+  }
+  PyMem_Free(pool->sessions);
+  PyMem_Free(pool->idle_since);
+  PyMem_Free(pool->address);
+}
+
+// Closes the idle sessions of `pool`.
+static void router_pool_drop_idle(RouterSessionPool *pool) {
+  while (pool->nsessions > 0) {
+    mg_session_destroy(pool->sessions[--pool->nsessions]);
+  }
+}
+
+static void router_clear_pools(RouterObject *self) {
+  for (Py_ssize_t i = 0; i < self->npools; ++i) {
+    router_pool_clear(&self->pools[i]);
+  }
+  PyMem_Free(self->pools);
+  self->pools = NULL;
+  self->npools = 0;
+}
+
+// Drops the pools of addresses that are no longer in the routing table.
+static void router_prune_pools(RouterObject *self) {
+  PyObject *table = self->table;
+  Py_ssize_t kept = 0;
+  for (Py_ssize_t i = 0; i < self->npools; ++i) {
+    if (table && routing_table_lists(table, self->pools[i].address)) {
+      self->pools[kept++] = self->pools[i];
+    } else {
+      router_pool_clear(&self->pools[i]);
+    }
+  }
+  self->npools = kept;
+}
+
+static RouterSessionPool *router_find_pool(RouterObject *self,
+                                           const char *address) {
+  for (Py_ssize_t i = 0; i < self->npools; ++i) {
+    if (strcmp(self->pools[i].address, address) == 0) {
+      return &self->pools[i];
+    }
+  }
+  return NULL;
+}
+
+// Takes an idle session to `address`, or returns NULL if there is none. The
+// most recently returned one is taken; sessions idle for longer than
+// `max_idle` are closed, as the server or a middlebox may have dropped them
+// without the session noticing.
+static mg_session *router_take_session(RouterObject *self,
+                                       const char *address) {
+  RouterSessionPool *pool = router_find_pool(self, address);
+  if (!pool || pool->nsessions == 0) {
+    return NULL;
+  }
+  if (self->max_idle > 0 &&
+      pool->idle_since[pool->nsessions - 1] <
+          timings_now() - (int64_t)(self->max_idle * 1e9)) {
+    // The others have been idle for even longer.
+    router_pool_drop_idle(pool);
+    return NULL;
+  }
+  while (pool->nsessions > 0) {
+    mg_session *session = pool->sessions[--pool->nsessions];
+    if (mg_session_status(session) == MG_SESSION_READY) {
+      return session;
+    }
+    mg_session_destroy(session);
+  }
+  return NULL;
+}
+
+// Finds the pool of `address`, creating it if needed. Returns NULL if the
+// address isn't in the routing table or there is no memory.
+static RouterSessionPool *router_pool_for(RouterObject *self,
+                                          const char *address) {
+  RouterSessionPool *pool = router_find_pool(self, address);
+  if (pool) {
+    return pool;
+  }
+  if (!self->table || !routing_table_lists(self->table, address)) {
+    return NULL;
+  }
+  RouterSessionPool *pools = PyMem_Realloc(
+      self->pools, (self->npools + 1) * sizeof(RouterSessionPool));
+  if (!pools) {
+    return NULL;
+  }
+  self->pools = pools;
+  pool = &self->pools[self->npools];
+  pool->address = router_strdup(address);
+  pool->sessions = PyMem_Malloc(self->max_idle_sessions * sizeof(mg_session *));
+  pool->idle_since = PyMem_Malloc(self->max_idle_sessions * sizeof(int64_t));
+  pool->nsessions = 0;
+  pool->latency = -1;
+  pool->in_flight = 0;
+  pool->failures = 0;
+  pool->open_until = 0;
+  pool->probing = 0;
+  if (!pool->address || !pool->sessions || !pool->idle_since) {
+    PyMem_Free(pool->address);
+    PyMem_Free(pool->sessions);
+    PyMem_Free(pool->idle_since);
+    return NULL;
+  }
+  self->npools++;
+  return pool;
+}
+
+// Keeps a session to `address` for reuse if it is still usable, the address
+// is still in the routing table and its pool has room, and destroys it
+// otherwise.
+static void router_give_session(RouterObject *self, const char *address,
+                                mg_session *session) {
+  RouterSessionPool *pool = mg_session_status(session) == MG_SESSION_READY
+                                ? router_pool_for(self, address)
+                                : NULL;
+  if (!pool || pool->nsessions == self->max_idle_sessions) {
+    mg_session_destroy(session);
+    return;
+  }
+  pool->idle_since[pool->nsessions] = timings_now();
+  pool->sessions[pool->nsessions++] = session;
+}
+
+// Counts a session to `address` as handed out.
+static void router_lend_session(RouterObject *self, const char *address) {
+  RouterSessionPool *pool = router_pool_for(self, address);
+  if (pool) {
+    pool->in_flight++;
+  }
+}
+
+// Undoes `router_lend_session` for a session that couldn't be had after all.
+static void router_unlend_session(RouterObject *self, const char *address) {
+  RouterSessionPool *pool = router_find_pool(self, address);
+  if (pool && pool->in_flight > 0) {
+    pool->in_flight--;
+  }
+}
+
+// -- circuit breaker ---------------------------------------------------------
+
+// Counts a transport failure of `address`. Opens its circuit once there were
+// `failure_threshold` in a row, or again right away if it was open before.
+static void router_instance_failed(RouterObject *self, const char *address) {
+  RouterSessionPool *pool = router_pool_for(self, address);
+  if (!pool) {
+    return;
+  }
+  pool->probing = 0;
+  if (self->failure_threshold == 0) {
+    return;
+  }
+  if (pool->open_until || ++pool->failures >= self->failure_threshold) {
+    pool->failures = 0;
+    pool->open_until =
+        timings_now() + (int64_t)(self->failure_cooldown * 1e9);
+    // The idle sessions most likely broke as well.
+    router_pool_drop_idle(pool);
+  }
+}
+
+// Closes the circuit of `address`, which just answered.
+static void router_instance_succeeded(RouterObject *self,
+                                      const char *address) {
+  RouterSessionPool *pool = router_find_pool(self, address);
+  if (pool) {
+    pool->failures = 0;
+    pool->open_until = 0;
+    pool->probing = 0;
+  }
+}
+
+// When the circuit of `address` closes again: 0 if it is closed, a time that
+// has passed if it is due to be probed, and INT64_MAX while another thread
+// probes it.
+static int64_t router_circuit_open_until(RouterObject *self,
+                                         const char *address) {
+  RouterSessionPool *pool = router_find_pool(self, address);
+  if (!pool) {
+    return 0;
+  }
+  return pool->probing ? INT64_MAX : pool->open_until;
+}
+
+// Takes back a session lent to a connection, given its stats, and keeps the
+// session for reuse if `reusable` is set and it is still usable. A session
+// that broke counts as a transport failure of its instance.
+static void router_return_session(RouterObject *self, const char *address,
+                                  mg_session *session,
+                                  const ConnectionStats *stats, int reusable) {
+  if (mg_session_status(session) == MG_SESSION_BAD) {
+    router_instance_failed(self, address);
+  } else if (stats && stats->queries > 0) {
+    router_instance_succeeded(self, address);
+  }
+  RouterSessionPool *pool = router_find_pool(self, address);
+  if (pool) {
+    if (pool->in_flight > 0) {
+      pool->in_flight--;
+    }
+    if (stats && stats->queries > 0) {
+      double sample = (double)stats->wait_time / 1e9 / (double)stats->queries;
+      if (pool->latency < 0) {
+        pool->latency = sample;
+      } else {
+        pool->latency += ROUTER_LATENCY_WEIGHT * (sample - pool->latency);
+      }
+    }
+  }
+  if (reusable) {
+    router_give_session(self, address, session);
+  } else {
+    mg_session_destroy(session);
+  }
+}
+
+// Takes back a reused session that broke, most likely closed by the server or
+// a middlebox while it sat idle. The other idle sessions to `address` are as
+// old or older and are closed as well. The instance itself isn't counted as
+// failing, since nothing says it is down.
+static void router_drop_stale_session(RouterObject *self, const char *address,
+                                      mg_session *session) {
+  RouterSessionPool *pool = router_find_pool(self, address);
+  if (pool) {
+    if (pool->in_flight > 0) {
+      pool->in_flight--;
+    }
+    router_pool_drop_idle(pool);
+  }
+  mg_session_destroy(session);
+}
+
+// Takes back the session of a closed routed connection. Only a session closed
+// outside of a transaction is reused.
+static void router_release_session(ConnectionObject *conn) {
+  const char *address = PyUnicode_AsUTF8(conn->session_key);
+  if (!address) {
+    PyErr_Clear();
+    mg_session_destroy(conn->session);
+    return;
+  }
+  router_return_session((RouterObject *)conn->session_home, address,
+                        conn->session, &conn->stats,
+                        conn->status == CONN_STATUS_READY);
+}
+
+// -- routing table -----------------------------------------------------------
+
+// Raises a new exception like `error`, which another thread raised first.
+static void router_raise_shared(PyObject *error) {
+  PyObject *args = PyObject_GetAttrString(error, "args");
+  if (args) {
+    PyErr_SetObject((PyObject *)Py_TYPE(error), args);
+    Py_DECREF(args);
+  }
+}
+
+// Waits for the refresh running in another thread and takes over its result.
+// Returns 0, or -1 with an exception set.
+static int router_join_refresh(RouterObject *self) {
+  int64_t start = timings_now();
+  while (self->refreshing) {
+    Py_BEGIN_ALLOW_THREADS;
+    PyThread_acquire_lock(self->refresh_done, WAIT_LOCK);
+    PyThread_release_lock(self->refresh_done);
+    Py_END_ALLOW_THREADS;
+  }
+  if (self->table_fetched >= start) {
+    return 0;
+  }
+  if (self->refresh_error) {
+    router_raise_shared(self->refresh_error);
+  } else {
+    PyErr_SetString(TransientError, "no routing table available");
+  }
+  return -1;
+}
+
+// Fetches a new routing table into the spare engine without holding the GIL
+// and swaps it in. If another thread is already fetching one, waits for it
+// instead. Returns 0, or -1 with an exception set.
+static int router_fetch_table(RouterObject *self) {
+  if (self->refreshing) {
+    return router_join_refresh(self);
+  }
+  RouterEngine *spare = &self->engines[!self->active];
+  router_clear_stashed(spare);
+
+  // Other threads keep using the active table meanwhile; the swap below happens
+  // with the GIL held. `refresh_done` is taken together with `refreshing` being
+  // set, so that a waiter that sees the flag always blocks on the lock. At most
+  // a waiter of the previous refresh may still be passing through it, which
+  // takes no GIL.
+  self->refreshing = 1;
+  PyThread_acquire_lock(self->refresh_done, WAIT_LOCK);
+  int status;
+  Py_BEGIN_ALLOW_THREADS;
+  status = mg_router_refresh(spare->router);
+  Py_END_ALLOW_THREADS;
+
+  Py_CLEAR(self->refresh_error);
+  int rc = -1;
+  if (status != 0) {
+    router_raise(spare, status);
+  } else {
+    const mg_routing_table *fetched = mg_router_routing_table(spare->router);
+    PyObject *snapshot = fetched ? routing_table_snapshot(fetched) : NULL;
+    if (!fetched) {
+      PyErr_SetString(TransientError, "no routing table available");
+    }
+    if (snapshot) {
+      PyObject *old = self->table;
+      self->table = snapshot;
+      self->table_ttl = (int64_t)mg_routing_table_ttl(fetched);
+      Py_XDECREF(old);
+      self->active = !self->active;
+      self->table_fetched = timings_now();
+      router_prune_pools(self);
+      rc = 0;
+    }
+  }
+  if (rc < 0) {
+    PyObject *type, *value, *tb;
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+    Py_XINCREF(value);
+    self->refresh_error = value;
+    PyErr_Restore(type, value, tb);
+  }
+  self->refreshing = 0;
+  PyThread_release_lock(self->refresh_done);
+  return rc;
+}
+
+// Makes sure a routing table is cached, fetching a new one if there is none,
+// the cached one has expired or it was fetched before `stale_before` (a
+// `timings_now()` value). Returns 0, or -1 with an exception set.
+static int router_update_table(RouterObject *self, int64_t stale_before) {
+  if (self->table && self->table_fetched >= stale_before &&
+      timings_now() - self->table_fetched <
+          self->table_ttl * (int64_t)1000000000) {
+    return 0;
+  }
+  return router_fetch_table(self);
+}
+
+// -- sessions ----------------------------------------------------------------
+
+// Opens a session to `target` ("host:port", with the host optionally in
+// brackets). Returns 0, or -1 with an exception set.
+static int router_connect_target(RouterObject *self, const char *target,
+                                 mg_session **session) {
+  const char *colon = strrchr(target, ':');
+  char *end = NULL;
+  long port = colon ? strtol(colon + 1, &end, 10) : -1;
+  if (!colon || end == colon + 1 || *end || port < 0 || port > 65535) {
+    PyErr_Format(OperationalError, "invalid server address '%s'", target);
+    return -1;
+  }
+  const char *host = target;
+  size_t host_size = (size_t)(colon - target);
+  if (host_size >= 2 && host[0] == '[' && host[host_size - 1] == ']') {
+    host++;
+    host_size -= 2;
+  }
+  char *hostname = PyMem_Malloc(host_size + 1);
+  if (!hostname) {
+    PyErr_NoMemory();
+    return -1;
+  }
+  memcpy(hostname, host, host_size);
+  hostname[host_size] = '\0';
+
+  mg_session_params *params = mg_session_params_make();
+  if (!params) {
+    PyMem_Free(hostname);
+    PyErr_SetString(PyExc_RuntimeError,
+                    "couldn't allocate session parameters object");
+    return -1;
+  }
+  mg_session_params_set_host(params, hostname);
+  mg_session_params_set_port(params, (uint16_t)port);
+  mg_session_params_set_username(params, self->username);
+  mg_session_params_set_password(params, self->password);
+  if (self->client_name) {
+    mg_session_params_set_user_agent(params, self->client_name);
+  }
+  mg_session_params_set_sslmode(params, self->sslmode);
+  mg_session_params_set_sslcert(params, self->sslcert);
+  mg_session_params_set_sslkey(params, self->sslkey);
+
+  // The parameters point into the settings, which __init__ leaves alone while
+  // `connecting` is set.
+  self->connecting++;
+  int status;
+  Py_BEGIN_ALLOW_THREADS;
+  status = mg_connect(params, session);
+  Py_END_ALLOW_THREADS;
+  self->connecting--;
+  mg_session_params_destroy(params);
+  PyMem_Free(hostname);
+  if (status != 0) {
+    PyObject *exc =
+        mg_error_is_transient(status) ? TransientError : OperationalError;
+    PyErr_SetString(exc, mg_session_error(*session));
+    mg_session_destroy(*session);
+    *session = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+// Gets a session to the instance advertised as `address`: an idle one, or a
+// new one to the first reachable target the resolver maps the address to.
+// Sets `reused` (unless NULL) to whether the session was idle. Returns 0, or
+// -1 with an exception set.
+static int router_acquire_session(RouterObject *self, const char *address,
+                                  mg_session **session, int *reused) {
+  *session = router_take_session(self, address);
+  if (reused) {
+    *reused = *session != NULL;
+  }
+  if (*session) {
+    return 0;
+  }
+  if (!self->resolver) {
+    return router_connect_target(self, address, session);
+  }
+
+  PyObject *targets = PyObject_CallFunction(self->resolver, "s", address);
+  if (!targets) {
+    return -1;
+  }
+  PyObject *seq =
+      PySequence_Fast(targets, "resolver must return an iterable of addresses");
+  Py_DECREF(targets);
+  if (!seq) {
+    return -1;
+  }
+  int rc = -1;
+  Py_ssize_t size = PySequence_Fast_GET_SIZE(seq);
+  if (size == 0) {
+    PyErr_Format(TransientError, "resolver returned no targets for '%s'",
+                 address);
+  }
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    const char *target = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(seq, i));
+    if (!target) {
+      break;
+    }
+    PyErr_Clear();
+    if ((rc = router_connect_target(self, target, session)) == 0) {
+      break;
+    }
+  }
+  Py_DECREF(seq);
+  return rc;
+}
+
+// Whether a failure to get a session may be worth retrying elsewhere, as
+// opposed to an error raised by the resolver or a bad configuration.
+static int router_connect_failed_transiently(void) {
+  return PyErr_ExceptionMatches(TransientError);
+}
+
+// Checks that a session to an instance whose circuit was open works, with a
+// query that costs the server next to nothing. Returns 0, or -1 with an
+// exception set.
+static int router_probe(mg_session *session) {
+  ConnectionObject *conn = (ConnectionObject *)connection_wrap_session(
+      session, /*owns_session=*/0, /*autocommit=*/1);
+  if (!conn) {
+    return -1;
+  }
+  int rc = connection_ping(conn);
+  conn->session = NULL;
+  conn->status = CONN_STATUS_CLOSED;
+  Py_DECREF(conn);
+  return rc;
+}
+
+// Gets a session to `address`, keeping its circuit breaker up to date. With
+// `probe` set, the instance's circuit is open and the session is probed first.
+// `reused` is passed on to `router_acquire_session`. Returns 0, or -1 with an
+// exception set.
+static int router_try_instance(RouterObject *self, const char *address,
+                               int probe, mg_session **session, int *reused) {
+  if (probe) {
+    RouterSessionPool *pool = router_find_pool(self, address);
+    if (pool) {
+      pool->probing = 1;
+    }
+  }
+  if (router_acquire_session(self, address, session, reused) < 0) {
+    if (router_connect_failed_transiently()) {
+      router_instance_failed(self, address);
+    } else if (probe) {
+      RouterSessionPool *pool = router_find_pool(self, address);
+      if (pool) {
+        pool->probing = 0;
+      }
+    }
+    return -1;
+  }
+  if (probe) {
+    if (router_probe(*session) < 0) {
+      mg_session_destroy(*session);
+      *session = NULL;
+      if (!PyErr_ExceptionMatches(TransientError)) {
+        PyErr_Clear();
+        PyErr_Format(TransientError, "probing '%s' failed", address);
+      }
+      router_instance_failed(self, address);
+      return -1;
+    }
+    router_instance_succeeded(self, address);
+  }
+  return 0;
+}
+
+// xorshift64*; quality is not a concern when picking replicas.
+static uint64_t router_random(RouterObject *self) {
+  self->random ^= self->random >> 12;
+  self->random ^= self->random << 25;
+  self->random ^= self->random >> 27;
+  return self->random * 2685821657736338717ULL;
+}
+
+// The expected cost of sending a read to `pool` (NULL if nothing is known
+// about the address): its latency times one plus its sessions in flight. An
+// instance whose latency hasn't been measured yet is taken to be as fast as
+// `fastest`, so that it gets measured.
+static double router_read_cost(const RouterSessionPool *pool, double fastest) {
+  if (!pool) {
+    return 0;
+  }
+  double latency = pool->latency < 0 ? fastest : pool->latency;
+  return latency * (double)(1 + pool->in_flight);
+}
+
+static RouterSessionPool *router_candidate_pool(RouterObject *self,
+                                                PyObject *candidates,
+                                                Py_ssize_t index) {
+  const char *address = PyUnicode_AsUTF8(PyTuple_GET_ITEM(candidates, index));
+  if (!address) {
+    PyErr_Clear();
+    return NULL;
+  }
+  return router_find_pool(self, address);
+}
+
+// Picks the READ address to try first by the power of two choices: of two
+// addresses drawn at random, the one with the lower expected cost, or with
+// fewer sessions in flight if the costs are equal.
+static Py_ssize_t router_pick_read(RouterObject *self, PyObject *candidates) {
+  Py_ssize_t count = PyTuple_GET_SIZE(candidates);
+  if (count < 2) {
+    return 0;
+  }
+  double fastest = 0;
+  for (Py_ssize_t i = 0; i < self->npools; ++i) {
+    double latency = self->pools[i].latency;
+    if (latency >= 0 && (fastest == 0 || latency < fastest)) {
+      fastest = latency;
+    }
+  }
+  Py_ssize_t a = (Py_ssize_t)(router_random(self) % (uint64_t)count);
+  Py_ssize_t b = (Py_ssize_t)(router_random(self) % (uint64_t)(count - 1));
+  if (b >= a) {
+    b++;
+  }
+  const RouterSessionPool *pa = router_candidate_pool(self, candidates, a);
+  const RouterSessionPool *pb = router_candidate_pool(self, candidates, b);
+  double ca = router_read_cost(pa, fastest);
+  double cb = router_read_cost(pb, fastest);
+  if (cb < ca ||
+      (cb == ca && pb && (!pa || pb->in_flight < pa->in_flight))) {
+    return b;
+  }
+  return a;
+}
+
+// Claims `candidate` before a session to it is acquired, which releases the
+// GIL: appends it to `claimed` (unless NULL), so that a concurrent hedged
+// attempt tries it last, and counts it as in flight, so that other reads
+// picked meanwhile see the load.
+static void router_claim(RouterObject *self, PyObject *claimed,
+                         PyObject *candidate, const char *address) {
+  if (claimed && PyList_Append(claimed, candidate) < 0) {
+    PyErr_Clear();
+  }
+  router_lend_session(self, address);
+}
+
+// Gets a session to a server of the given role, trying the role's addresses
+// in turn (starting with the one `router_pick_read` picks for reads) and
+// counting it as in flight until it is returned. Addresses in `claimed` (a
+// list, or NULL) are tried last, and each one tried is appended to it. On
+// success, stores the address in `address` (a new reference), sets `reused`
+// (unless NULL) to whether the session was idle, and returns 0. Returns -1
+// with an exception set otherwise.
+static int router_session_for_role(RouterObject *self, int write,
+                                   PyObject *claimed, mg_session **session,
+                                   PyObject **address, int *reused) {
+  PyObject *candidates =
+      self->table
+          ? PyTuple_GET_ITEM(self->table, write ? TABLE_WRITE : TABLE_READ)
+          : NULL;
+  Py_ssize_t count = candidates ? PyTuple_GET_SIZE(candidates) : 0;
+  if (count == 0) {
+    PyErr_Format(TransientError, "no server serving %s in the routing table",
+                 write ? "writes" : "reads");
+    return -1;
+  }
+  // Put the candidates in the order they are tried, which also holds on to
+  // them while other threads may swap in a new table.
+  Py_ssize_t start = write ? 0 : router_pick_read(self, candidates);
+  PyObject *order = PyTuple_New(count);
+  if (!order) {
+    return -1;
+  }
+  Py_ssize_t head = 0;
+  Py_ssize_t tail = count;
+  for (Py_ssize_t i = 0; i < count; ++i) {
+    PyObject *candidate = PyTuple_GET_ITEM(candidates, (start + i) % count);
+    int taken = claimed ? PySequence_Contains(claimed, candidate) : 0;
+    if (taken < 0) {
+      Py_DECREF(order);
+      return -1;
+    }
+    Py_INCREF(candidate);
+    PyTuple_SET_ITEM(order, taken ? --tail : head++, candidate);
+  }
+
+  int rc = -1;
+  int tried = 0;
+  PyObject *chosen = NULL;
+  // The candidate whose open circuit closes first, in case all are open.
+  PyObject *soonest = NULL;
+  int64_t soonest_until = INT64_MAX;
+  for (Py_ssize_t i = 0; i < count; ++i) {
+    PyObject *candidate = PyTuple_GET_ITEM(order, i);
+    const char *candidate_address = PyUnicode_AsUTF8(candidate);
+    if (!candidate_address) {
+      break;
+    }
+    int64_t open_until = router_circuit_open_until(self, candidate_address);
+    if (open_until > timings_now()) {
+      if (open_until < soonest_until) {
+        soonest = candidate;
+        soonest_until = open_until;
+      }
+      continue;
+    }
+    tried = 1;
+    router_claim(self, claimed, candidate, candidate_address);
+    if (router_try_instance(self, candidate_address, open_until != 0, session,
+                            reused) == 0) {
+      rc = 0;
+      chosen = candidate;
+      break;
+    }
+    router_unlend_session(self, candidate_address);
+    if (!router_connect_failed_transiently()) {
+      break;
+    }
+  }
+  // Rather than failing outright when every circuit is open, probe the
+  // instance that is due first.
+  if (rc < 0 && !tried) {
+    if (soonest) {
+      const char *soonest_address = PyUnicode_AsUTF8(soonest);
+      router_claim(self, claimed, soonest, soonest_address);
+      rc = router_try_instance(self, soonest_address, 1, session, reused);
+      if (rc < 0) {
+        router_unlend_session(self, soonest_address);
+      }
+      chosen = soonest;
+    } else if (!PyErr_Occurred()) {
+      PyErr_Format(TransientError,
+                   "every server serving %s is being probed",
+                   write ? "writes" : "reads");
+    }
+  }
+  if (rc == 0) {
+    PyErr_Clear();
+    Py_INCREF(chosen);
+    *address = chosen;
+  }
+  Py_DECREF(order);
   return rc;
 }
 
 // -- lifecycle ---------------------------------------------------------------
 
+// Destroys the engines. They borrow `resolver` as their resolver_data, so this
+// must come before releasing it.
+static void router_clear_engines(RouterObject *self) {
+  for (int i = 0; i < 2; ++i) {
+    mg_router_destroy(self->engines[i].router);
+    self->engines[i].router = NULL;
+    router_clear_stashed(&self->engines[i]);
+  }
+}
+
+static void router_clear_settings(RouterObject *self) {
+  PyMem_Free(self->username);
+  PyMem_Free(self->password);
+  PyMem_Free(self->client_name);
+  PyMem_Free(self->sslcert);
+  PyMem_Free(self->sslkey);
+  self->username = self->password = self->client_name = NULL;
+  self->sslcert = self->sslkey = NULL;
+}
+
 static int router_init(RouterObject *self, PyObject *args, PyObject *kwargs) {
   static char *kwlist[] = {"host",
                            "address",
@@ -131,6 +1011,10 @@ static int router_init(RouterObject *self, PyObject *args, PyObject *kwargs) {
                            "max_retries",
                            "retry_backoff",
                            "retry_backoff_cap",
+                           "max_idle_sessions",
+                           "max_idle",
+                           "failure_threshold",
+                           "failure_cooldown",
                            NULL};
 
   const char *host = NULL;
@@ -147,12 +1031,35 @@ static int router_init(RouterObject *self, PyObject *args, PyObject *kwargs) {
   unsigned int max_retries = 8;
   double retry_backoff = 1.0;
   double retry_backoff_cap = 15.0;
+  Py_ssize_t max_idle_sessions = 4;
+  double max_idle = 600.0;
+  unsigned int failure_threshold = 3;
+  double failure_cooldown = 5.0;
 
   if (!PyArg_ParseTupleAndKeywords(
-          args, kwargs, "|$zzizzzizzOOIdd", kwlist, &host, &address, &port,
-          &username, &password, &client_name, &sslmode_int, &sslcert, &sslkey,
-          &resolver, &routing_context, &max_retries, &retry_backoff,
-          &retry_backoff_cap)) {
+          args, kwargs, "|$zzizzzizzOOIddndId", kwlist, &host, &address,
+          &port, &username, &password, &client_name, &sslmode_int, &sslcert,
+          &sslkey, &resolver, &routing_context, &max_retries, &retry_backoff,
+          &retry_backoff_cap, &max_idle_sessions, &max_idle, &failure_threshold,
+          &failure_cooldown)) {
+    return -1;
+  }
+
+  if (self->refreshing || self->connecting) {
+    PyErr_SetString(InterfaceError,
+                    "cannot reinitialize a router while other threads use it");
+    return -1;
+  }
+  if (max_idle_sessions < 0) {
+    PyErr_SetString(PyExc_ValueError, "max_idle_sessions must be non-negative");
+    return -1;
+  }
+  if (max_idle < 0) {
+    PyErr_SetString(PyExc_ValueError, "max_idle must be non-negative");
+    return -1;
+  }
+  if (failure_cooldown < 0) {
+    PyErr_SetString(PyExc_ValueError, "failure_cooldown must be non-negative");
     return -1;
   }
 
@@ -227,26 +1134,77 @@ static int router_init(RouterObject *self, PyObject *args, PyObject *kwargs) {
   if (resolver && resolver != Py_None) {
     stored_resolver = resolver;
     Py_INCREF(stored_resolver);
-    mg_router_config_set_resolver(config, router_resolver_trampoline, self);
   }
 
-  mg_router *router = mg_router_make(config);
+  mg_router *routers[2];
+  for (int i = 0; i < 2; ++i) {
+    if (stored_resolver) {
+      mg_router_config_set_resolver(config, router_resolver_trampoline,
+                                    &self->engines[i]);
+    }
+    routers[i] = mg_router_make(config);
+  }
   mg_session_params_destroy(params);
   mg_map_destroy(mg_routing_context);
   mg_router_config_destroy(config);
 
-  if (!router) {
+  if (!routers[0] || !routers[1]) {
+    mg_router_destroy(routers[0]);
+    mg_router_destroy(routers[1]);
     Py_XDECREF(stored_resolver);
     PyErr_SetString(PyExc_RuntimeError, "couldn't create router");
     return -1;
   }
 
+  char *copies[] = {router_strdup(username), router_strdup(password),
+                    router_strdup(client_name), router_strdup(sslcert),
+                    router_strdup(sslkey)};
+  const char *originals[] = {username, password, client_name, sslcert, sslkey};
+  for (size_t i = 0; i < sizeof(copies) / sizeof(copies[0]); ++i) {
+    if (originals[i] && !copies[i]) {
+      for (size_t j = 0; j < sizeof(copies) / sizeof(copies[0]); ++j) {
+        PyMem_Free(copies[j]);
+      }
+      mg_router_destroy(routers[0]);
+      mg_router_destroy(routers[1]);
+      Py_XDECREF(stored_resolver);
+      PyErr_NoMemory();
+      return -1;
+    }
+  }
+
   // Replace any previous state (in case __init__ is called twice).
-  mg_router_destroy(self->router);
+  router_clear_pools(self);
+  router_clear_settings(self);
+  router_clear_engines(self);
   Py_XDECREF(self->resolver);
-  router_clear_stashed(self);
-  self->router = router;
+  for (int i = 0; i < 2; ++i) {
+    self->engines[i].router = routers[i];
+    self->engines[i].owner = self;
+  }
+  self->active = 0;
   self->resolver = stored_resolver;
+  self->username = copies[0];
+  self->password = copies[1];
+  self->client_name = copies[2];
+  self->sslcert = copies[3];
+  self->sslkey = copies[4];
+  self->sslmode = sslmode;
+  self->max_retries = max_retries;
+  self->retry_backoff = retry_backoff;
+  self->retry_backoff_cap = retry_backoff_cap;
+  self->max_idle_sessions = max_idle_sessions;
+  self->max_idle = max_idle;
+  self->failure_threshold = failure_threshold;
+  self->failure_cooldown = failure_cooldown;
+  Py_CLEAR(self->table);
+  self->table_ttl = 0;
+  self->table_fetched = 0;
+  Py_CLEAR(self->refresh_error);
+  self->random = (uint64_t)timings_now() ^ (uint64_t)(uintptr_t)self;
+  if (!self->random) {
+    self->random = 1;
+  }
   return 0;
 }
 
@@ -258,39 +1216,70 @@ static PyObject *router_new(PyTypeObject *subtype, PyObject *args,
   if (!self) {
     return NULL;
   }
-  self->router = NULL;
+  // Everything else is zeroed by tp_alloc.
   self->resolver = NULL;
-  self->exc_type = self->exc_value = self->exc_tb = NULL;
+  if (!(self->refresh_done = PyThread_allocate_lock()) ||
+      !(self->backoff_timer = PyThread_allocate_lock())) {
+    Py_DECREF(self);
+    PyErr_SetString(PyExc_RuntimeError, "couldn't allocate lock");
+    return NULL;
+  }
+  PyThread_acquire_lock(self->backoff_timer, WAIT_LOCK);
   return (PyObject *)self;
 }
 
 static void router_dealloc(RouterObject *self) {
-  // Destroy the router first: it borrows `resolver` as its resolver_data.
-  mg_router_destroy(self->router);
+  router_clear_pools(self);
+  router_clear_settings(self);
+  router_clear_engines(self);
   Py_XDECREF(self->resolver);
-  router_clear_stashed(self);
+  Py_XDECREF(self->table);
+  Py_XDECREF(self->refresh_error);
+  if (self->refresh_done) {
+    PyThread_free_lock(self->refresh_done);
+  }
+  if (self->backoff_timer) {
+    PyThread_release_lock(self->backoff_timer);
+    PyThread_free_lock(self->backoff_timer);
+  }
   Py_TYPE(self)->tp_free(self);
 }
 
 // -- connect -----------------------------------------------------------------
 
 static PyObject *router_connect_role(RouterObject *self, int write) {
-  router_clear_stashed(self);
-  mg_session *session = NULL;
-  int status = write ? mg_router_connect_write(self->router, &session)
-                     : mg_router_connect_read(self->router, &session);
-  if (status != 0) {
-    router_raise(self, status);
-    return NULL;
-  }
-  // The caller owns the returned connection; it owns and closes the session.
-  PyObject *conn = connection_wrap_session(session, /*owns_session=*/1,
-                                           /*autocommit=*/0);
-  if (!conn) {
-    mg_session_destroy(session);
-    return NULL;
+  // Try the cached routing table first, then one fetched after that failed.
+  int64_t stale_before = 0;
+  for (int fresh = 0; fresh < 2; ++fresh) {
+    if (router_update_table(self, stale_before) < 0) {
+      return NULL;
+    }
+    mg_session *session;
+    PyObject *address;
+    if (router_session_for_role(self, write, NULL, &session, &address,
+                                NULL) == 0) {
+      // The caller owns the returned connection; it owns the session, which
+      // goes back to this router's pool when the connection is closed.
+      ConnectionObject *conn = (ConnectionObject *)connection_wrap_session(
+          session, /*owns_session=*/1, /*autocommit=*/0);
+      if (!conn) {
+        router_return_session(self, PyUnicode_AsUTF8(address), session,
+                              NULL, 1);
+        Py_DECREF(address);
+        return NULL;
+      }
+      Py_INCREF(self);
+      conn->session_home = (PyObject *)self;
+      conn->session_key = address;
+      conn->session_release = router_release_session;
+      return (PyObject *)conn;
+    }
+    if (!router_connect_failed_transiently()) {
+      return NULL;
+    }
+    stale_before = timings_now();
   }
-  return conn;
+  return NULL;
 }
 
 PyDoc_STRVAR(router_connect_read_doc,
@@ -313,159 +1302,240 @@ static PyObject *router_connect_write(RouterObject *self, PyObject *args) {
 
 // -- managed transactions ----------------------------------------------------
 
-struct work_ctx {
-  RouterObject *self;
-  PyObject *work;    // borrowed
-  PyObject *result;  // owned; the value returned by the last successful work
-};
-
-// Bridges libmgclient's `mg_work_fn` to the Python work callable, which
-// receives a Cursor and returns the caller's result. A raised exception is
-// stashed and mapped to a transient/non-transient status so the retry loop in
-// libmgclient can decide whether to try again.
-static int router_work_trampoline(mg_session *session, void *data) {
-  struct work_ctx *ctx = (struct work_ctx *)data;
-  RouterObject *self = ctx->self;
-
-  // A fresh attempt: drop any exception stashed by a previous one.
-  router_clear_stashed(self);
-
-  // The work runs against a borrowed connection in autocommit mode: for a
-  // write, libmgclient owns the BEGIN/COMMIT around this callback, so the
-  // Python layer must not drive the transaction itself.
+// Sleeps for `seconds` without holding the GIL, waking up early to run signal
+// handlers. Returns 0, or -1 with an exception set if one raised (for example
+// KeyboardInterrupt).
+static int router_sleep(RouterObject *self, double seconds) {
+  int64_t until = timings_now() + (int64_t)(seconds * 1e9);
+  for (;;) {
+    int64_t remaining = until - timings_now();
+    if (remaining <= 0) {
+      return 0;
+    }
+    PY_TIMEOUT_T microseconds = remaining / 1000;
+    if (microseconds > PY_TIMEOUT_MAX) {
+      microseconds = PY_TIMEOUT_MAX;
+    }
+    PyLockStatus status;
+    Py_BEGIN_ALLOW_THREADS;
+    status = PyThread_acquire_lock_timed(self->backoff_timer, microseconds, 1);
+    Py_END_ALLOW_THREADS;
+    if (status == PY_LOCK_INTR && PyErr_CheckSignals() < 0) {
+      return -1;
+    }
+  }
+}
+
+// Runs `work(cursor)` once on a pooled session to a server of the given role.
+// For a write, the work runs in a transaction that is committed afterwards.
+// `claimed` is passed on to `router_session_for_role`. Returns the work's
+// result, or NULL with an exception set. `stale` is set if the attempt failed
+// because an idle session it reused had broken, which is worth retrying on a
+// new session right away.
+static PyObject *router_attempt(RouterObject *self, PyObject *work,
+                                int write, PyObject *claimed, int *stale) {
+  *stale = 0;
+  if (router_update_table(self, 0) < 0) {
+    return NULL;
+  }
+  mg_session *session;
+  PyObject *address;
+  int reused;
+  if (router_session_for_role(self, write, claimed, &session, &address,
+                              &reused) < 0) {
+    return NULL;
+  }
+
+  // The work runs against a borrowed connection, detached again below so that
+  // a cursor kept by the work can't reach the session once it is reused.
   PyObject *conn = connection_wrap_session(session, /*owns_session=*/0,
-                                           /*autocommit=*/1);
+                                           /*autocommit=*/!write);
   if (!conn) {
-    router_stash_exception(self);
-    return MG_ERROR_CLIENT_ERROR;
+    router_return_session(self, PyUnicode_AsUTF8(address), session, NULL, 1);
+    Py_DECREF(address);
+    return NULL;
   }
+  PyObject *result = NULL;
   PyObject *cursor = PyObject_CallMethod(conn, "cursor", NULL);
-  if (!cursor) {
-    router_stash_exception(self);
-    Py_DECREF(conn);
-    return MG_ERROR_CLIENT_ERROR;
+  if (cursor) {
+    result = PyObject_CallFunctionObjArgs(work, cursor, NULL);
+    Py_DECREF(cursor);
+  }
+  if (result && write) {
+    PyObject *committed = PyObject_CallMethod(conn, "commit", NULL);
+    if (committed) {
+      Py_DECREF(committed);
+    } else {
+      Py_CLEAR(result);
+    }
   }
 
-  PyObject *result = PyObject_CallFunctionObjArgs(ctx->work, cursor, NULL);
-  Py_DECREF(cursor);
+  // Leave the session ready for the next user, keeping the work's exception.
+  PyObject *type, *value, *tb;
+  PyErr_Fetch(&type, &value, &tb);
+  ConnectionObject *c = (ConnectionObject *)conn;
+  if (c->status == CONN_STATUS_EXECUTING ||
+      c->status == CONN_STATUS_IN_TRANSACTION) {
+    if (connection_reset(c) < 0) {
+      PyErr_Clear();
+    }
+  }
+  ConnectionStats stats = c->stats;
+  c->session = NULL;
+  c->status = CONN_STATUS_CLOSED;
   Py_DECREF(conn);
+  PyErr_Restore(type, value, tb);
 
-  if (!result) {
-    int transient = PyErr_ExceptionMatches(TransientError);
-    router_stash_exception(self);
-    return transient ? MG_ERROR_TRANSIENT_ERROR : MG_ERROR_CLIENT_ERROR;
+  if (!result && reused && mg_session_status(session) == MG_SESSION_BAD &&
+      PyErr_ExceptionMatches(TransientError)) {
+    *stale = 1;
+    router_drop_stale_session(self, PyUnicode_AsUTF8(address), session);
+  } else {
+    router_return_session(self, PyUnicode_AsUTF8(address), session, &stats,
+                          1);
   }
-  Py_XSETREF(ctx->result, result);
-  return 0;
+  Py_DECREF(address);
+  return result;
 }
 
-static PyObject *router_execute_role(RouterObject *self, PyObject *work,
-                                     int write) {
+static PyObject *router_execute_role(RouterObject *self, PyObject *args,
+                                     PyObject *kwargs, int write) {
+  static char *kwlist[] = {"work", "timeout", "claimed", NULL};
+  PyObject *work;
+  PyObject *pytimeout = Py_None;
+  PyObject *claimed = Py_None;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$OO", kwlist, &work,
+                                   &pytimeout, &claimed)) {
+    return NULL;
+  }
   if (!PyCallable_Check(work)) {
     PyErr_SetString(PyExc_TypeError, "work argument must be callable");
     return NULL;
   }
-  router_clear_stashed(self);
-
-  struct work_ctx ctx = {.self = self, .work = work, .result = NULL};
-  int status =
-      write ? mg_router_execute_write(self->router, router_work_trampoline,
-                                      &ctx)
-            : mg_router_execute_read(self->router, router_work_trampoline,
-                                     &ctx);
-
-  if (status != 0) {
-    Py_XDECREF(ctx.result);
-    router_raise(self, status);
+  if (claimed == Py_None) {
+    claimed = NULL;
+  } else if (!PyList_Check(claimed)) {
+    PyErr_SetString(PyExc_TypeError, "claimed must be a list");
     return NULL;
   }
-  // Success: discard any exception stashed by an earlier, retried attempt.
-  router_clear_stashed(self);
-  if (ctx.result == NULL) {
-    Py_RETURN_NONE;
+  // No retry is started (or slept for) past the deadline, if any.
+  int64_t deadline = -1;
+  if (pytimeout != Py_None) {
+    double timeout = PyFloat_AsDouble(pytimeout);
+    if (timeout == -1.0 && PyErr_Occurred()) {
+      return NULL;
+    }
+    if (timeout < 0) {
+      PyErr_SetString(PyExc_ValueError, "timeout must be non-negative");
+      return NULL;
+    }
+    deadline = timings_now() + (int64_t)(timeout * 1e9);
+  }
+
+  const char *event = write ? "execute_write" : "execute_read";
+  int64_t trace = trace_start(event, NULL);
+  PyObject *result;
+  for (uint32_t attempt = 0;; ++attempt) {
+    int64_t started = timings_now();
+    int stale;
+    if ((result = router_attempt(self, work, write, claimed, &stale))) {
+      break;
+    }
+    // A reused session that broke says nothing about the instance. Retry on a
+    // new session at once, without using up an attempt. This ends, as the
+    // instance's idle sessions were all closed.
+    if (stale && (deadline < 0 || timings_now() < deadline)) {
+      PyErr_Clear();
+      attempt--;
+      continue;
+    }
+    // Retry transient conditions (an instance unreachable during a failover,
+    // a replica catching up, a dropped connection) with capped exponential
+    // backoff, against a routing table fetched since the attempt started (by
+    // this thread or, when many fail at once, by whichever got there first).
+    if (!PyErr_ExceptionMatches(TransientError) ||
+        attempt >= self->max_retries) {
+      break;
+    }
+    double backoff =
+        self->retry_backoff * (double)(1u << (attempt < 30 ? attempt : 30));
+    if (backoff > self->retry_backoff_cap) {
+      backoff = self->retry_backoff_cap;
+    }
+    // Give up with the last error if the retry couldn't start in time.
+    if (deadline >= 0 && timings_now() + (int64_t)(backoff * 1e9) >= deadline) {
+      break;
+    }
+    PyErr_Clear();
+    if (router_sleep(self, backoff) < 0) {
+      break;
+    }
+    if (router_update_table(self, started) < 0 &&
+        !PyErr_ExceptionMatches(TransientError)) {
+      break;
+    }
+    PyErr_Clear();
   }
-  return ctx.result;  // reference transferred to the caller
+  trace_end(trace, event, NULL, -1, !result);
+  return result;
 }
 
 PyDoc_STRVAR(router_execute_read_doc,
-             "execute_read(work)\n--\n\n"
-             "Run work(cursor) as a managed read against a replica.");
+             "execute_read(work, *, timeout=None, claimed=None)\n--\n\n"
+             "Run work(cursor) as a managed read against a replica. "
+             "Addresses in the list claimed are tried last, and the ones "
+             "tried are appended to it.");
 
-static PyObject *router_execute_read(RouterObject *self, PyObject *work) {
-  return router_execute_role(self, work, /*write=*/0);
+static PyObject *router_execute_read(RouterObject *self, PyObject *args,
+                                     PyObject *kwargs) {
+  return router_execute_role(self, args, kwargs, /*write=*/0);
 }
 
 PyDoc_STRVAR(router_execute_write_doc,
-             "execute_write(work)\n--\n\n"
+             "execute_write(work, *, timeout=None, claimed=None)\n--\n\n"
              "Run work(cursor) as a managed write against the main.");
 
-static PyObject *router_execute_write(RouterObject *self, PyObject *work) {
-  return router_execute_role(self, work, /*write=*/1);
+static PyObject *router_execute_write(RouterObject *self, PyObject *args,
+                                      PyObject *kwargs) {
+  return router_execute_role(self, args, kwargs, /*write=*/1);
 }
 
 // -- refresh / routing table -------------------------------------------------
 
 PyDoc_STRVAR(router_refresh_doc,
              "refresh()\n--\n\n"
-             "Force an immediate refresh of the cached routing table.");
+             "Force an immediate refresh of the cached routing table. If "
+             "another thread is already fetching one, wait for it instead.");
 
 static PyObject *router_refresh(RouterObject *self, PyObject *args) {
   (void)args;
-  router_clear_stashed(self);
-  int status = mg_router_refresh(self->router);
-  if (status != 0) {
-    router_raise(self, status);
+  if (router_update_table(self, timings_now()) < 0) {
     return NULL;
   }
   Py_RETURN_NONE;
 }
 
-static PyObject *role_addresses(const mg_routing_table *table,
-                                enum mg_routing_role role) {
-  uint32_t count = mg_routing_table_address_count(table, role);
-  PyObject *list = PyList_New(count);
-  if (!list) {
-    return NULL;
-  }
-  for (uint32_t i = 0; i < count; ++i) {
-    PyObject *item =
-        PyUnicode_FromString(mg_routing_table_address_at(table, role, i));
-    if (!item) {
-      Py_DECREF(list);
-      return NULL;
-    }
-    PyList_SET_ITEM(list, i, item);  // steals reference
-  }
-  return list;
-}
-
 PyDoc_STRVAR(router_routing_table_doc,
              "routing_table()\n--\n\n"
              "Return the cached routing table (refreshing it if none is "
-             "cached yet) as a dict with 'ttl', 'write', 'read' and 'route'.");
+             "cached yet or it has expired) as a dict with 'ttl', 'write', "
+             "'read' and 'route'.");
 
 static PyObject *router_routing_table(RouterObject *self, PyObject *args) {
   (void)args;
-  router_clear_stashed(self);
-
-  if (mg_router_routing_table(self->router) == NULL) {
-    int status = mg_router_refresh(self->router);
-    if (status != 0) {
-      router_raise(self, status);
-      return NULL;
-    }
+  if (router_update_table(self, 0) < 0) {
+    return NULL;
   }
-  const mg_routing_table *table = mg_router_routing_table(self->router);
+  PyObject *table = self->table;
   if (!table) {
     PyErr_SetString(TransientError, "no routing table available");
     return NULL;
   }
 
-  PyObject *write = role_addresses(table, MG_ROUTING_ROLE_WRITE);
-  PyObject *read = role_addresses(table, MG_ROUTING_ROLE_READ);
-  PyObject *route = role_addresses(table, MG_ROUTING_ROLE_ROUTE);
-  PyObject *ttl =
-      PyLong_FromLongLong((long long)mg_routing_table_ttl(table));
+  PyObject *write = PySequence_List(PyTuple_GET_ITEM(table, TABLE_WRITE));
+  PyObject *read = PySequence_List(PyTuple_GET_ITEM(table, TABLE_READ));
+  PyObject *route = PySequence_List(PyTuple_GET_ITEM(table, TABLE_ROUTE));
+  PyObject *ttl = PyLong_FromLongLong((long long)self->table_ttl);
   PyObject *dict = NULL;
   if (write && read && route && ttl) {
     dict = PyDict_New();
@@ -492,23 +1562,147 @@ static PyObject *router_routing_table(RouterObject *self, PyObject *args) {
   return dict;
 }
 
+PyDoc_STRVAR(router_prefetch_doc,
+             "prefetch()\n--\n\n"
+             "Fetch a new routing table without holding the GIL and swap it "
+             "in for the cached one. Returns the new table's TTL in seconds, "
+             "or None if another thread is already fetching one.");
+
+static PyObject *router_prefetch(RouterObject *self, PyObject *args) {
+  (void)args;
+  if (self->refreshing) {
+    Py_RETURN_NONE;
+  }
+  if (router_fetch_table(self) < 0) {
+    return NULL;
+  }
+  return PyLong_FromLongLong((long long)self->table_ttl);
+}
+
+PyDoc_STRVAR(router_table_age_doc,
+             "table_age()\n--\n\n"
+             "Return how many seconds ago the cached routing table was "
+             "fetched and its TTL in seconds, or None if none is cached. "
+             "Never fetches a table.");
+
+static PyObject *router_table_age(RouterObject *self, PyObject *args) {
+  (void)args;
+  if (!self->table) {
+    Py_RETURN_NONE;
+  }
+  double age = (double)(timings_now() - self->table_fetched) / 1e9;
+  return Py_BuildValue("(dL)", age, (long long)self->table_ttl);
+}
+
+PyDoc_STRVAR(router_close_idle_sessions_doc,
+             "close_idle_sessions()\n--\n\n"
+             "Close all idle sessions kept for reuse.");
+
+static PyObject *router_close_idle_sessions(RouterObject *self,
+                                            PyObject *args) {
+  (void)args;
+  for (Py_ssize_t i = 0; i < self->npools; ++i) {
+    RouterSessionPool *pool = &self->pools[i];
+    while (pool->nsessions > 0) {
+      mg_session_destroy(pool->sessions[--pool->nsessions]);
+    }
+  }
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(router_idle_sessions_doc,
+             "idle_sessions()\n--\n\n"
+             "Return the number of idle sessions kept for reuse, as a dict "
+             "keyed by address.");
+
+static PyObject *router_idle_sessions(RouterObject *self, PyObject *args) {
+  (void)args;
+  PyObject *dict = PyDict_New();
+  if (!dict) {
+    return NULL;
+  }
+  for (Py_ssize_t i = 0; i < self->npools; ++i) {
+    if (self->pools[i].nsessions == 0) {
+      continue;
+    }
+    PyObject *count = PyLong_FromSsize_t(self->pools[i].nsessions);
+    if (!count ||
+        PyDict_SetItemString(dict, self->pools[i].address, count) < 0) {
+      Py_XDECREF(count);
+      Py_DECREF(dict);
+      return NULL;
+    }
+    Py_DECREF(count);
+  }
+  return dict;
+}
+
+PyDoc_STRVAR(router_instances_doc,
+             "instances()\n--\n\n"
+             "Return what the router observed about the data instances it "
+             "used, as a dict keyed by address of dicts with 'latency' (the "
+             "moving average of the time to answer a query in seconds, or "
+             "None), 'in_flight', 'idle' and 'circuit_open'.");
+
+static PyObject *router_instances(RouterObject *self, PyObject *args) {
+  (void)args;
+  PyObject *dict = PyDict_New();
+  if (!dict) {
+    return NULL;
+  }
+  for (Py_ssize_t i = 0; i < self->npools; ++i) {
+    const RouterSessionPool *pool = &self->pools[i];
+    PyObject *latency = pool->latency < 0 ? Py_None
+                                          : PyFloat_FromDouble(pool->latency);
+    if (latency == Py_None) {
+      Py_INCREF(latency);
+    }
+    int open = pool->probing || pool->open_until > timings_now();
+    PyObject *info =
+        latency ? Py_BuildValue("{s:O,s:n,s:n,s:O}", "latency", latency,
+                                "in_flight", pool->in_flight, "idle",
+                                pool->nsessions, "circuit_open",
+                                open ? Py_True : Py_False)
+                : NULL;
+    Py_XDECREF(latency);
+    if (!info || PyDict_SetItemString(dict, pool->address, info) < 0) {
+      Py_XDECREF(info);
+      Py_DECREF(dict);
+      return NULL;
+    }
+    Py_DECREF(info);
+  }
+  return dict;
+}
+
 static PyMethodDef router_methods[] = {
     {"connect_read", (PyCFunction)router_connect_read, METH_NOARGS,
      router_connect_read_doc},
     {"connect_write", (PyCFunction)router_connect_write, METH_NOARGS,
      router_connect_write_doc},
-    {"execute_read", (PyCFunction)router_execute_read, METH_O,
-     router_execute_read_doc},
-    {"execute_write", (PyCFunction)router_execute_write, METH_O,
-     router_execute_write_doc},
+    {"execute_read", (PyCFunction)router_execute_read,
+     METH_VARARGS | METH_KEYWORDS, router_execute_read_doc},
+    {"execute_write", (PyCFunction)router_execute_write,
+     METH_VARARGS | METH_KEYWORDS, router_execute_write_doc},
     {"refresh", (PyCFunction)router_refresh, METH_NOARGS, router_refresh_doc},
     {"routing_table", (PyCFunction)router_routing_table, METH_NOARGS,
      router_routing_table_doc},
+    {"prefetch", (PyCFunction)router_prefetch, METH_NOARGS,
+     router_prefetch_doc},
+    {"table_age", (PyCFunction)router_table_age, METH_NOARGS,
+     router_table_age_doc},
+    {"idle_sessions", (PyCFunction)router_idle_sessions, METH_NOARGS,
+     router_idle_sessions_doc},
+    {"instances", (PyCFunction)router_instances, METH_NOARGS,
+     router_instances_doc},
+    {"close_idle_sessions", (PyCFunction)router_close_idle_sessions,
+     METH_NOARGS, router_close_idle_sessions_doc},
     {NULL, NULL, 0, NULL}};
 
 PyDoc_STRVAR(RouterType_doc,
              "Low-level client-side routing engine over libmgclient's "
-             "mg_router. Use mgclient.routing.Router instead.");
+             "mg_router, with pooled sessions to data instances. Use "
+             "mgclient.routing.Router instead.");
 
 // clang-format off
 PyTypeObject RouterType = {
@@ -0,0 +1,784 @@
+// Copyright (c) 2016-2020 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "spill.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "glue.h"
+
+// The spill file easily outgrows 2 GiB, so plain fseek won't do.
+#ifdef _WIN32
+#define spill_fseek _fseeki64
+#else
+#define spill_fseek fseeko
+#endif
+
+// Records are encoded as a tree of values, each a one-byte `mg_value_type`
+// followed by its payload in native byte order (the file never leaves the
+// process): integers are 8 bytes, sizes and counts are 4 bytes and strings are
+// a size followed by the bytes.
+
+struct Spill {
+  FILE *file;
+  // offsets[i] is where record i starts, offsets[count] where the file ends.
+  int64_t *offsets;
+  Py_ssize_t count;
+  Py_ssize_t capacity;
+  // Current file position, to avoid seeking when reading sequentially, and
+  // whether the last operation was a write (stdio needs a seek in between
+  // switching from writing to reading or back).
+  int64_t position;
+  int writing;
+  // Scratch buffer for encoding and decoding a single record.
+  char *buffer;
+  size_t buffer_size;
+  size_t buffer_capacity;
+};
+
+Spill *spill_new(void) {
+  Spill *spill = PyMem_New(Spill, 1);
+  if (!spill) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  memset(spill, 0, sizeof(Spill));
+
+  spill->capacity = 64;
+  if (!(spill->offsets = PyMem_New(int64_t, spill->capacity + 1))) {
+    PyMem_Free(spill);
+    PyErr_NoMemory();
+    return NULL;
+  }
+  spill->offsets[0] = 0;
+
+  if (!(spill->file = tmpfile())) {
+    PyErr_SetFromErrno(PyExc_OSError);
+    spill_destroy(spill);
+    return NULL;
+  }
+  return spill;
+}
+
+void spill_destroy(Spill *spill) {
+  if (!spill) {
+    return;
+  }
+  if (spill->file) {
+    // Temporary files are removed when closed.
+    fclose(spill->file);
+  }
+  PyMem_Free(spill->offsets);
+  PyMem_Free(spill->buffer);
+  PyMem_Free(spill);
+}
+
+Py_ssize_t spill_size(const Spill *spill) { return spill->count; }
+
+static int spill_reserve(Spill *spill, size_t size) {
+  if (size <= spill->buffer_capacity) {
+    return 0;
+  }
+  size_t capacity = spill->buffer_capacity ? spill->buffer_capacity : 256;
+  while (capacity < size) {
+    capacity *= 2;
+  }
+  char *buffer = PyMem_Realloc(spill->buffer, capacity);
+  if (!buffer) {
+    PyErr_NoMemory();
+    return -1;
+  }
+  spill->buffer = buffer;
+  spill->buffer_capacity = capacity;
+  return 0;
+}
+
+static int spill_put(Spill *spill, const void *data, size_t size) {
+  if (spill_reserve(spill, spill->buffer_size + size) < 0) {
+    return -1;
+  }
+  memcpy(spill->buffer + spill->buffer_size, data, size);
+  spill->buffer_size += size;
+  return 0;
+}
+
+static int spill_put_type(Spill *spill, enum mg_value_type type) {
+  uint8_t tag = (uint8_t)type;
+  return spill_put(spill, &tag, sizeof(tag));
+}
+
+static int spill_put_u32(Spill *spill, uint32_t value) {
+  return spill_put(spill, &value, sizeof(value));
+}
+
+static int spill_put_i64(Spill *spill, int64_t value) {
+  return spill_put(spill, &value, sizeof(value));
+}
+
+static int spill_put_string(Spill *spill, const mg_string *string) {
+  uint32_t size = mg_string_size(string);
+  if (spill_put_u32(spill, size) < 0) {
+    return -1;
+  }
+  return spill_put(spill, mg_string_data(string), size);
+}
+
+static int spill_put_value(Spill *spill, const mg_value *value);
+
+static int spill_put_list(Spill *spill, const mg_list *list) {
+  if (spill_put_u32(spill, mg_list_size(list)) < 0) {
+    return -1;
+  }
+  for (uint32_t i = 0; i < mg_list_size(list); ++i) {
+    if (spill_put_value(spill, mg_list_at(list, i)) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int spill_put_map(Spill *spill, const mg_map *map) {
+  if (spill_put_u32(spill, mg_map_size(map)) < 0) {
+    return -1;
+  }
+  for (uint32_t i = 0; i < mg_map_size(map); ++i) {
+    if (spill_put_string(spill, mg_map_key_at(map, i)) < 0 ||
+        spill_put_value(spill, mg_map_value_at(map, i)) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int spill_put_node(Spill *spill, const mg_node *node) {
+  if (spill_put_i64(spill, mg_node_id(node)) < 0 ||
+      spill_put_u32(spill, mg_node_label_count(node)) < 0) {
+    return -1;
+  }
+  for (uint32_t i = 0; i < mg_node_label_count(node); ++i) {
+    if (spill_put_string(spill, mg_node_label_at(node, i)) < 0) {
+      return -1;
+    }
+  }
+  return spill_put_map(spill, mg_node_properties(node));
+}
+
+static int spill_put_unbound_relationship(Spill *spill,
+                                          const mg_unbound_relationship *rel) {
+  if (spill_put_i64(spill, mg_unbound_relationship_id(rel)) < 0 ||
+      spill_put_string(spill, mg_unbound_relationship_type(rel)) < 0) {
+    return -1;
+  }
+  return spill_put_map(spill, mg_unbound_relationship_properties(rel));
+}
+
+static int spill_put_value(Spill *spill, const mg_value *value) {
+  enum mg_value_type type = mg_value_get_type(value);
+  if (spill_put_type(spill, type) < 0) {
+    return -1;
+  }
+  switch (type) {
+    case MG_VALUE_TYPE_NULL:
+      return 0;
+    case MG_VALUE_TYPE_BOOL:
+      return spill_put_i64(spill, mg_value_bool(value));
+    case MG_VALUE_TYPE_INTEGER:
+      return spill_put_i64(spill, mg_value_integer(value));
+    case MG_VALUE_TYPE_FLOAT: {
+      double number = mg_value_float(value);
+      return spill_put(spill, &number, sizeof(number));
+    }
+    case MG_VALUE_TYPE_STRING:
+      return spill_put_string(spill, mg_value_string(value));
+    case MG_VALUE_TYPE_LIST:
+      return spill_put_list(spill, mg_value_list(value));
+    case MG_VALUE_TYPE_MAP:
+      return spill_put_map(spill, mg_value_map(value));
+    case MG_VALUE_TYPE_NODE:
+      return spill_put_node(spill, mg_value_node(value));
+    case MG_VALUE_TYPE_RELATIONSHIP: {
+      const mg_relationship *rel = mg_value_relationship(value);
+      if (spill_put_i64(spill, mg_relationship_id(rel)) < 0 ||
+          spill_put_i64(spill, mg_relationship_start_id(rel)) < 0 ||
+          spill_put_i64(spill, mg_relationship_end_id(rel)) < 0 ||
+          spill_put_string(spill, mg_relationship_type(rel)) < 0) {
+        return -1;
+      }
+      return spill_put_map(spill, mg_relationship_properties(rel));
+    }
+    case MG_VALUE_TYPE_UNBOUND_RELATIONSHIP:
+      return spill_put_unbound_relationship(
+          spill, mg_value_unbound_relationship(value));
+    case MG_VALUE_TYPE_PATH: {
+      // Stored expanded: the nodes and relationships in path order.
+      const mg_path *path = mg_value_path(value);
+      uint32_t length = mg_path_length(path);
+      if (spill_put_u32(spill, length) < 0) {
+        return -1;
+      }
+      for (uint32_t i = 0; i <= length; ++i) {
+        if (spill_put_node(spill, mg_path_node_at(path, i)) < 0) {
+          return -1;
+        }
+      }
+      for (uint32_t i = 0; i < length; ++i) {
+        if (spill_put_i64(spill, mg_path_relationship_reversed_at(path, i)) <
+                0 ||
+            spill_put_unbound_relationship(
+                spill, mg_path_relationship_at(path, i)) < 0) {
+          return -1;
+        }
+      }
+      return 0;
+    }
+    case MG_VALUE_TYPE_DATE:
+      return spill_put_i64(spill, mg_date_days(mg_value_date(value)));
+    case MG_VALUE_TYPE_LOCAL_TIME:
+      return spill_put_i64(
+          spill, mg_local_time_nanoseconds(mg_value_local_time(value)));
+    case MG_VALUE_TYPE_LOCAL_DATE_TIME: {
+      const mg_local_date_time *ldt = mg_value_local_date_time(value);
+      if (spill_put_i64(spill, mg_local_date_time_seconds(ldt)) < 0) {
+        return -1;
+      }
+      return spill_put_i64(spill, mg_local_date_time_nanoseconds(ldt));
+    }
+    case MG_VALUE_TYPE_DATE_TIME: {
+      const mg_date_time *dt = mg_value_date_time(value);
+      if (spill_put_i64(spill, mg_date_time_seconds(dt)) < 0 ||
+          spill_put_i64(spill, mg_date_time_nanoseconds(dt)) < 0) {
+        return -1;
+      }
+      return spill_put_i64(spill, mg_date_time_tz_offset_minutes(dt));
+    }
+    case MG_VALUE_TYPE_DATE_TIME_ZONE_ID: {
+      const mg_date_time_zone_id *dt = mg_value_date_time_zone_id(value);
+      if (spill_put_i64(spill, mg_date_time_zone_id_seconds(dt)) < 0 ||
+          spill_put_i64(spill, mg_date_time_zone_id_nanoseconds(dt)) < 0) {
+        return -1;
+      }
+      return spill_put_string(spill, mg_date_time_zone_id_timezone_name(dt));
+    }
+    case MG_VALUE_TYPE_DURATION: {
+      const mg_duration *duration = mg_value_duration(value);
+      if (spill_put_i64(spill, mg_duration_days(duration)) < 0 ||
+          spill_put_i64(spill, mg_duration_seconds(duration)) < 0) {
+        return -1;
+      }
+      return spill_put_i64(spill, mg_duration_nanoseconds(duration));
+    }
+    default:
+      PyErr_SetString(PyExc_RuntimeError,
+                      "encountered a mg_value of unknown type");
+      return -1;
+  }
+}
+
+int spill_append(Spill *spill, const mg_list *record) {
+  spill->buffer_size = 0;
+  if (spill_put_list(spill, record) < 0) {
+    return -1;
+  }
+
+  if (spill->count == spill->capacity) {
+    Py_ssize_t capacity = 2 * spill->capacity;
+    int64_t *offsets = PyMem_Resize(spill->offsets, int64_t, capacity + 1);
+    if (!offsets) {
+      PyErr_NoMemory();
+      return -1;
+    }
+    spill->offsets = offsets;
+    spill->capacity = capacity;
+  }
+
+  int64_t end = spill->offsets[spill->count];
+  if (spill->position != end || !spill->writing) {
+    if (spill_fseek(spill->file, end, SEEK_SET) != 0) {
+      PyErr_SetFromErrno(PyExc_OSError);
+      return -1;
+    }
+  }
+  if (fwrite(spill->buffer, 1, spill->buffer_size, spill->file) !=
+      spill->buffer_size) {
+    PyErr_SetFromErrno(PyExc_OSError);
+    // Where the file position is now is anyone's guess.
+    spill->position = -1;
+    return -1;
+  }
+  spill->writing = 1;
+  spill->position = end + (int64_t)spill->buffer_size;
+  spill->offsets[++spill->count] = spill->position;
+  return 0;
+}
+
+typedef struct {
+  const char *pos;
+  const char *end;
+} SpillReader;
+
+static int spill_get_bytes(SpillReader *reader, void *data, size_t size) {
+  if ((size_t)(reader->end - reader->pos) < size) {
+    PyErr_SetString(PyExc_RuntimeError, "corrupted spilled record");
+    return -1;
+  }
+  memcpy(data, reader->pos, size);
+  reader->pos += size;
+  return 0;
+}
+
+static int spill_get_u32(SpillReader *reader, uint32_t *value) {
+  return spill_get_bytes(reader, value, sizeof(*value));
+}
+
+static int spill_get_i64(SpillReader *reader, int64_t *value) {
+  return spill_get_bytes(reader, value, sizeof(*value));
+}
+
+static mg_string *spill_get_string(SpillReader *reader) {
+  uint32_t size;
+  if (spill_get_u32(reader, &size) < 0) {
+    return NULL;
+  }
+  if ((size_t)(reader->end - reader->pos) < size) {
+    PyErr_SetString(PyExc_RuntimeError, "corrupted spilled record");
+    return NULL;
+  }
+  mg_string *string = mg_string_make2(size, reader->pos);
+  if (!string) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  reader->pos += size;
+  return string;
+}
+
+static mg_value *spill_get_value(SpillReader *reader);
+
+static mg_list *spill_get_list(SpillReader *reader) {
+  uint32_t size;
+  if (spill_get_u32(reader, &size) < 0) {
+    return NULL;
+  }
+  mg_list *list = mg_list_make_empty(size);
+  if (!list) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  for (uint32_t i = 0; i < size; ++i) {
+    mg_value *value = spill_get_value(reader);
+    if (!value) {
+      mg_list_destroy(list);
+      return NULL;
+    }
+    mg_list_append(list, value);
+  }
+  return list;
+}
+
+static mg_map *spill_get_map(SpillReader *reader) {
+  uint32_t size;
+  if (spill_get_u32(reader, &size) < 0) {
+    return NULL;
+  }
+  mg_map *map = mg_map_make_empty(size);
+  if (!map) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  for (uint32_t i = 0; i < size; ++i) {
+    mg_string *key = spill_get_string(reader);
+    if (!key) {
+      mg_map_destroy(map);
+      return NULL;
+    }
+    mg_value *value = spill_get_value(reader);
+    if (!value) {
+      mg_string_destroy(key);
+      mg_map_destroy(map);
+      return NULL;
+    }
+    // Keys were unique when the map was received.
+    mg_map_insert_unsafe2(map, key, value);
+  }
+  return map;
+}
+
+static mg_node *spill_get_node(SpillReader *reader) {
+  int64_t id;
+  uint32_t label_count;
+  if (spill_get_i64(reader, &id) < 0 ||
+      spill_get_u32(reader, &label_count) < 0) {
+    return NULL;
+  }
+  if ((size_t)(reader->end - reader->pos) / sizeof(uint32_t) < label_count) {
+    PyErr_SetString(PyExc_RuntimeError, "corrupted spilled record");
+    return NULL;
+  }
+
+  mg_node *node = NULL;
+  mg_map *properties = NULL;
+  uint32_t read = 0;
+  mg_string **labels = PyMem_New(mg_string *, label_count ? label_count : 1);
+  if (!labels) {
+    PyErr_NoMemory();
+    return NULL;
+  }
+  for (; read < label_count; ++read) {
+    if (!(labels[read] = spill_get_string(reader))) {
+      goto cleanup;
+    }
+  }
+  if (!(properties = spill_get_map(reader))) {
+    goto cleanup;
+  }
+  if (!(node = mg_node_make(id, label_count, labels, properties))) {
+    PyErr_NoMemory();
+    mg_map_destroy(properties);
+    goto cleanup;
+  }
+  // The node took ownership of the labels.
+  PyMem_Free(labels);
+  return node;
+
+cleanup:
+  for (uint32_t i = 0; i < read; ++i) {
+    mg_string_destroy(labels[i]);
+  }
+  PyMem_Free(labels);
+  return NULL;
+}
+
+static mg_unbound_relationship *spill_get_unbound_relationship(
+    SpillReader *reader) {
+  int64_t id;
+  if (spill_get_i64(reader, &id) < 0) {
+    return NULL;
+  }
+  mg_string *type = spill_get_string(reader);
+  if (!type) {
+    return NULL;
+  }
+  mg_map *properties = spill_get_map(reader);
+  if (!properties) {
+    mg_string_destroy(type);
+    return NULL;
+  }
+  mg_unbound_relationship *rel =
+      mg_unbound_relationship_make(id, type, properties);
+  if (!rel) {
+    PyErr_NoMemory();
+    mg_string_destroy(type);
+    mg_map_destroy(properties);
+  }
+  return rel;
+}
+
+static mg_path *spill_get_path(SpillReader *reader) {
+  uint32_t length;
+  if (spill_get_u32(reader, &length) < 0) {
+    return NULL;
+  }
+  if ((size_t)(reader->end - reader->pos) / sizeof(int64_t) < length) {
+    PyErr_SetString(PyExc_RuntimeError, "corrupted spilled record");
+    return NULL;
+  }
+
+  mg_path *path = NULL;
+  uint32_t nodes_read = 0;
+  uint32_t rels_read = 0;
+  mg_node **nodes = PyMem_New(mg_node *, length + 1);
+  mg_unbound_relationship **rels =
+      PyMem_New(mg_unbound_relationship *, length ? length : 1);
+  int64_t *sequence = PyMem_New(int64_t, 2 * (size_t)length + 1);
+  if (!nodes || !rels || !sequence) {
+    PyErr_NoMemory();
+    goto cleanup;
+  }
+
+  for (; nodes_read <= length; ++nodes_read) {
+    if (!(nodes[nodes_read] = spill_get_node(reader))) {
+      goto cleanup;
+    }
+  }
+  // Every node and relationship appears once, in order, so the sequence just
+  // alternates between consecutive (1-based, signed if reversed) relationship
+  // and node indices.
+  for (; rels_read < length; ++rels_read) {
+    int64_t reversed;
+    if (spill_get_i64(reader, &reversed) < 0 ||
+        !(rels[rels_read] = spill_get_unbound_relationship(reader))) {
+      goto cleanup;
+    }
+    int64_t index = (int64_t)rels_read + 1;
+    sequence[2 * rels_read] = reversed ? -index : index;
+    sequence[2 * rels_read + 1] = index;
+  }
+
+  if (!(path = mg_path_make(length + 1, nodes, length, rels, 2 * length,
+                            sequence))) {
+    PyErr_NoMemory();
+    goto cleanup;
+  }
+  // The path took ownership of the nodes and relationships.
+  nodes_read = 0;
+  rels_read = 0;
+
+cleanup:
+  for (uint32_t i = 0; i < nodes_read; ++i) {
+    mg_node_destroy(nodes[i]);
+  }
+  for (uint32_t i = 0; i < rels_read; ++i) {
+    mg_unbound_relationship_destroy(rels[i]);
+  }
+  PyMem_Free(nodes);
+  PyMem_Free(rels);
+  PyMem_Free(sequence);
+  return path;
+}
+
+static mg_value *spill_get_value(SpillReader *reader) {
+  uint8_t tag;
+  if (spill_get_bytes(reader, &tag, sizeof(tag)) < 0) {
+    return NULL;
+  }
+
+  mg_value *value = NULL;
+  int64_t a, b, c;
+  switch ((enum mg_value_type)tag) {
+    case MG_VALUE_TYPE_NULL:
+      value = mg_value_make_null();
+      break;
+    case MG_VALUE_TYPE_BOOL:
+      if (spill_get_i64(reader, &a) < 0) {
+        return NULL;
+      }
+      value = mg_value_make_bool((int)a);
+      break;
+    case MG_VALUE_TYPE_INTEGER:
+      if (spill_get_i64(reader, &a) < 0) {
+        return NULL;
+      }
+      value = mg_value_make_integer(a);
+      break;
+    case MG_VALUE_TYPE_FLOAT: {
+      double number;
+      if (spill_get_bytes(reader, &number, sizeof(number)) < 0) {
+        return NULL;
+      }
+      value = mg_value_make_float(number);
+      break;
+    }
+    case MG_VALUE_TYPE_STRING: {
+      mg_string *string = spill_get_string(reader);
+      if (!string) {
+        return NULL;
+      }
+      if (!(value = mg_value_make_string2(string))) {
+        mg_string_destroy(string);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_LIST: {
+      mg_list *list = spill_get_list(reader);
+      if (!list) {
+        return NULL;
+      }
+      if (!(value = mg_value_make_list(list))) {
+        mg_list_destroy(list);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_MAP: {
+      mg_map *map = spill_get_map(reader);
+      if (!map) {
+        return NULL;
+      }
+      if (!(value = mg_value_make_map(map))) {
+        mg_map_destroy(map);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_NODE: {
+      mg_node *node = spill_get_node(reader);
+      if (!node) {
+        return NULL;
+      }
+      if (!(value = mg_value_make_node(node))) {
+        mg_node_destroy(node);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_RELATIONSHIP: {
+      if (spill_get_i64(reader, &a) < 0 || spill_get_i64(reader, &b) < 0 ||
+          spill_get_i64(reader, &c) < 0) {
+        return NULL;
+      }
+      mg_string *type = spill_get_string(reader);
+      if (!type) {
+        return NULL;
+      }
+      mg_map *properties = spill_get_map(reader);
+      if (!properties) {
+        mg_string_destroy(type);
+        return NULL;
+      }
+      mg_relationship *rel = mg_relationship_make(a, b, c, type, properties);
+      if (!rel) {
+        mg_string_destroy(type);
+        mg_map_destroy(properties);
+      } else if (!(value = mg_value_make_relationship(rel))) {
+        mg_relationship_destroy(rel);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_UNBOUND_RELATIONSHIP: {
+      mg_unbound_relationship *rel = spill_get_unbound_relationship(reader);
+      if (!rel) {
+        return NULL;
+      }
+      if (!(value = mg_value_make_unbound_relationship(rel))) {
+        mg_unbound_relationship_destroy(rel);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_PATH: {
+      mg_path *path = spill_get_path(reader);
+      if (!path) {
+        return NULL;
+      }
+      if (!(value = mg_value_make_path(path))) {
+        mg_path_destroy(path);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_DATE: {
+      if (spill_get_i64(reader, &a) < 0) {
+        return NULL;
+      }
+      mg_date *date = mg_date_make(a);
+      if (date && !(value = mg_value_make_date(date))) {
+        mg_date_destroy(date);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_LOCAL_TIME: {
+      if (spill_get_i64(reader, &a) < 0) {
+        return NULL;
+      }
+      mg_local_time *lt = mg_local_time_make(a);
+      if (lt && !(value = mg_value_make_local_time(lt))) {
+        mg_local_time_destroy(lt);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_LOCAL_DATE_TIME: {
+      if (spill_get_i64(reader, &a) < 0 || spill_get_i64(reader, &b) < 0) {
+        return NULL;
+      }
+      mg_local_date_time *ldt = mg_local_date_time_make(a, b);
+      if (ldt && !(value = mg_value_make_local_date_time(ldt))) {
+        mg_local_date_time_destroy(ldt);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_DATE_TIME: {
+      if (spill_get_i64(reader, &a) < 0 || spill_get_i64(reader, &b) < 0 ||
+          spill_get_i64(reader, &c) < 0) {
+        return NULL;
+      }
+      mg_date_time *dt = mg_date_time_make(a, b, (int32_t)c);
+      if (dt && !(value = mg_value_make_date_time(dt))) {
+        mg_date_time_destroy(dt);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_DATE_TIME_ZONE_ID: {
+      if (spill_get_i64(reader, &a) < 0 || spill_get_i64(reader, &b) < 0) {
+        return NULL;
+      }
+      mg_string *name = spill_get_string(reader);
+      if (!name) {
+        return NULL;
+      }
+      // The constructor wants a null-terminated name.
+      char *name_str = PyMem_Malloc(mg_string_size(name) + 1);
+      if (!name_str) {
+        mg_string_destroy(name);
+        PyErr_NoMemory();
+        return NULL;
+      }
+      memcpy(name_str, mg_string_data(name), mg_string_size(name));
+      name_str[mg_string_size(name)] = '\0';
+      mg_string_destroy(name);
+      mg_date_time_zone_id *dt = mg_date_time_zone_id_make(a, b, name_str);
+      PyMem_Free(name_str);
+      if (dt && !(value = mg_value_make_date_time_zone_id(dt))) {
+        mg_date_time_zone_id_destroy(dt);
+      }
+      break;
+    }
+    case MG_VALUE_TYPE_DURATION: {
+      if (spill_get_i64(reader, &a) < 0 || spill_get_i64(reader, &b) < 0 ||
+          spill_get_i64(reader, &c) < 0) {
+        return NULL;
+      }
+      mg_duration *duration = mg_duration_make(0, a, b, c);
+      if (duration && !(value = mg_value_make_duration(duration))) {
+        mg_duration_destroy(duration);
+      }
+      break;
+    }
+    default:
+      PyErr_SetString(PyExc_RuntimeError, "corrupted spilled record");
+      return NULL;
+  }
+
+  if (!value) {
+    PyErr_NoMemory();
+  }
+  return value;
+}
+
+PyObject *spill_get(Spill *spill, Py_ssize_t index) {
+  assert(index >= 0 && index < spill->count);
+
+  int64_t start = spill->offsets[index];
+  size_t size = (size_t)(spill->offsets[index + 1] - start);
+  if (spill_reserve(spill, size) < 0) {
+    return NULL;
+  }
+  if (spill->position != start || spill->writing) {
+    if (spill_fseek(spill->file, start, SEEK_SET) != 0) {
+      PyErr_SetFromErrno(PyExc_OSError);
+      return NULL;
+    }
+  }
+  if (fread(spill->buffer, 1, size, spill->file) != size) {
+    PyErr_SetFromErrno(PyExc_OSError);
+    spill->position = -1;
+    return NULL;
+  }
+  spill->writing = 0;
+  spill->position = start + (int64_t)size;
+
+  SpillReader reader = {spill->buffer, spill->buffer + size};
+  mg_list *record = spill_get_list(&reader);
+  if (!record) {
+    return NULL;
+  }
+  PyObject *row = mg_list_to_py_tuple(record);
+  mg_list_destroy(record);
+  return row;
+}
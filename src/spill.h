@@ -0,0 +1,43 @@
+// Copyright (c) 2016-2020 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PYMGCLIENT_SPILL_H
+#define PYMGCLIENT_SPILL_H
+
+#include <Python.h>
+
+#include <mgclient.h>
+
+// Records of a query result stored in a temporary file instead of memory.
+// Records are written in a compact binary form as they are received and
+// decoded into tuples only when read, so just their offsets stay resident.
+typedef struct Spill Spill;
+
+// Creates an empty spill backed by a new temporary file. Returns NULL with an
+// exception set on failure.
+Spill *spill_new(void);
+
+void spill_destroy(Spill *spill);
+
+// Appends a record. Returns -1 with an exception set on failure.
+int spill_append(Spill *spill, const mg_list *record);
+
+// Number of records appended so far.
+Py_ssize_t spill_size(const Spill *spill);
+
+// Reads the record at `index` back as a tuple, like `mg_list_to_py_tuple`.
+// Returns NULL with an exception set on failure.
+PyObject *spill_get(Spill *spill, Py_ssize_t index);
+
+#endif
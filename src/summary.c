@@ -0,0 +1,157 @@
+// Copyright (c) 2016-2020 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "summary.h"
+
+#include <structmember.h>
+
+static void result_summary_dealloc(ResultSummaryObject *summary) {
+  Py_CLEAR(summary->data);
+  Py_TYPE(summary)->tp_free(summary);
+}
+
+static PyObject *result_summary_repr(ResultSummaryObject *summary) {
+  return PyUnicode_FromFormat("<%s(%R) at %p>", Py_TYPE(summary)->tp_name,
+                              summary->data, summary);
+}
+
+PyObject *result_summary_from_dict(PyObject *data) {
+  assert(PyDict_Check(data));
+  ResultSummaryObject *summary =
+      (ResultSummaryObject *)ResultSummaryType.tp_alloc(&ResultSummaryType, 0);
+  if (!summary) {
+    return NULL;
+  }
+  Py_INCREF(data);
+  summary->data = data;
+  return (PyObject *)summary;
+}
+
+// Getter for a top-level summary field named `key`, or None if the server
+// didn't send it.
+static PyObject *result_summary_get_field(ResultSummaryObject *summary,
+                                          void *key) {
+  PyObject *value = PyDict_GetItemString(summary->data, (const char *)key);
+  if (!value) {
+    Py_RETURN_NONE;
+  }
+  Py_INCREF(value);
+  return value;
+}
+
+// Getter for the update counter named `key`, or 0 if the server didn't send
+// it (it only reports counters that changed).
+static PyObject *result_summary_get_counter(ResultSummaryObject *summary,
+                                            void *key) {
+  PyObject *stats = PyDict_GetItemString(summary->data, "stats");
+  PyObject *value = NULL;
+  if (stats && PyDict_Check(stats)) {
+    value = PyDict_GetItemString(stats, (const char *)key);
+  }
+  if (!value) {
+    return PyLong_FromLong(0);
+  }
+  Py_INCREF(value);
+  return value;
+}
+
+static PyObject *result_summary_get_stats(ResultSummaryObject *summary,
+                                          void *data) {
+  (void)data;
+  PyObject *stats = PyDict_GetItemString(summary->data, "stats");
+  if (!stats) {
+    return PyDict_New();
+  }
+  Py_INCREF(stats);
+  return stats;
+}
+
+// clang-format off
+PyDoc_STRVAR(ResultSummaryType_data_doc,
+"The summary as sent by the server, as a :class:`dict`.");
+
+PyDoc_STRVAR(ResultSummaryType_stats_doc,
+"The update counters reported by the server, as a :class:`dict` (empty if\n\
+the query changed nothing).");
+
+PyDoc_STRVAR(ResultSummaryType_time_doc,
+"Time in seconds the server spent in this phase of the query, or ``None``\n\
+if it wasn't reported.");
+
+PyDoc_STRVAR(ResultSummaryType_field_doc,
+"The field of the same name sent by the server, or ``None`` if it wasn't\n\
+reported.");
+
+PyDoc_STRVAR(ResultSummaryType_counter_doc,
+"Update counter reported by the server, 0 if it wasn't reported.");
+// clang-format on
+
+static PyMemberDef result_summary_members[] = {
+    {"data", T_OBJECT, offsetof(ResultSummaryObject, data), READONLY,
+     ResultSummaryType_data_doc},
+    {NULL}};
+
+static PyGetSetDef result_summary_getset[] = {
+    {"parsing_time", (getter)result_summary_get_field, NULL,
+     ResultSummaryType_time_doc, "parsing_time"},
+    {"planning_time", (getter)result_summary_get_field, NULL,
+     ResultSummaryType_time_doc, "planning_time"},
+    {"plan_execution_time", (getter)result_summary_get_field, NULL,
+     ResultSummaryType_time_doc, "plan_execution_time"},
+    {"cost_estimate", (getter)result_summary_get_field, NULL,
+     ResultSummaryType_field_doc, "cost_estimate"},
+    {"type", (getter)result_summary_get_field, NULL,
+     ResultSummaryType_field_doc, "type"},
+    {"notifications", (getter)result_summary_get_field, NULL,
+     ResultSummaryType_field_doc, "notifications"},
+    {"stats", (getter)result_summary_get_stats, NULL,
+     ResultSummaryType_stats_doc, NULL},
+    {"nodes_created", (getter)result_summary_get_counter, NULL,
+     ResultSummaryType_counter_doc, "nodes-created"},
+    {"nodes_deleted", (getter)result_summary_get_counter, NULL,
+     ResultSummaryType_counter_doc, "nodes-deleted"},
+    {"relationships_created", (getter)result_summary_get_counter, NULL,
+     ResultSummaryType_counter_doc, "relationships-created"},
+    {"relationships_deleted", (getter)result_summary_get_counter, NULL,
+     ResultSummaryType_counter_doc, "relationships-deleted"},
+    {"labels_added", (getter)result_summary_get_counter, NULL,
+     ResultSummaryType_counter_doc, "labels-added"},
+    {"labels_removed", (getter)result_summary_get_counter, NULL,
+     ResultSummaryType_counter_doc, "labels-removed"},
+    {"properties_set", (getter)result_summary_get_counter, NULL,
+     ResultSummaryType_counter_doc, "properties-set"},
+    {NULL}};
+
+// clang-format off
+PyDoc_STRVAR(ResultSummaryType_doc,
+"Summary the server sent after the last record of a query's result.\n\
+\n\
+Accessible through :attr:`Cursor.summary` once all the results have been\n\
+received.");
+// clang-format on
+
+// clang-format off
+PyTypeObject ResultSummaryType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "mgclient.ResultSummary",
+    .tp_basicsize = sizeof(ResultSummaryObject),
+    .tp_itemsize = 0,
+    .tp_dealloc = (destructor)result_summary_dealloc,
+    .tp_repr = (reprfunc)result_summary_repr,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = ResultSummaryType_doc,
+    .tp_members = result_summary_members,
+    .tp_getset = result_summary_getset,
+};
+// clang-format on
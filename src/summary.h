@@ -0,0 +1,35 @@
+// Copyright (c) 2016-2020 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PYMGCLIENT_SUMMARY_H
+#define PYMGCLIENT_SUMMARY_H
+
+#include <Python.h>
+
+// clang-format off
+typedef struct {
+  PyObject_HEAD
+
+  // The summary map sent by the server, as a dict.
+  PyObject *data;
+} ResultSummaryObject;
+// clang-format on
+
+extern PyTypeObject ResultSummaryType;
+
+// Creates a ResultSummary wrapping `data`, the dict of a result summary.
+PyObject *result_summary_from_dict(PyObject *data);
+
+#endif
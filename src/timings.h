@@ -0,0 +1,74 @@
+// Copyright (c) 2016-2020 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PYMGCLIENT_TIMINGS_H
+#define PYMGCLIENT_TIMINGS_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// Monotonic clock in nanoseconds.
+static inline int64_t timings_now(void) {
+#ifdef _WIN32
+  static LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  if (!frequency.QuadPart) {
+    QueryPerformanceFrequency(&frequency);
+  }
+  QueryPerformanceCounter(&counter);
+  return (int64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+}
+
+// Client-side timing breakdown of a query. Only compiled in when the extension
+// is built with PYMGCLIENT_TIMINGS defined (`setup.py build_ext --timings`);
+// otherwise all of the macros below expand to nothing.
+#ifdef PYMGCLIENT_TIMINGS
+
+// Nanoseconds spent in each phase.
+typedef struct {
+  // Sending RUN until the result columns arrive.
+  int64_t run;
+  // Sending PULL.
+  int64_t pull;
+  // Waiting for records to arrive.
+  int64_t fetch;
+  // Converting records to Python objects.
+  int64_t decode;
+} Timings;
+
+#define TIMINGS_START(start) int64_t start = timings_now()
+#define TIMINGS_STOP(timings, phase, start) \
+  ((timings).phase += timings_now() - (start))
+#define TIMINGS_RESET(timings) memset(&(timings), 0, sizeof(Timings))
+
+#else
+
+#define TIMINGS_START(start)
+#define TIMINGS_STOP(timings, phase, start)
+#define TIMINGS_RESET(timings)
+
+#endif
+
+#endif
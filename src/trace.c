@@ -0,0 +1,80 @@
+// Copyright (c) 2016-2020 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "trace.h"
+
+#include "timings.h"
+
+PyObject *trace_hook = NULL;
+
+// Calls the hook with `event`, `phase` and `info` (stolen). Errors raised by
+// the hook are reported as unraisable, so that a broken hook can't change the
+// outcome of the traced operation.
+static void trace_call(const char *event, const char *phase, PyObject *info) {
+  if (!info) {
+    PyErr_WriteUnraisable(trace_hook);
+    return;
+  }
+  // The hook may unset itself.
+  PyObject *hook = trace_hook;
+  Py_INCREF(hook);
+  PyObject *result = PyObject_CallFunction(hook, "ssO", event, phase, info);
+  if (result) {
+    Py_DECREF(result);
+  } else {
+    PyErr_WriteUnraisable(hook);
+  }
+  Py_DECREF(hook);
+  Py_DECREF(info);
+}
+
+int64_t trace_call_start(const char *event, const char *query) {
+  trace_call(event, "start", Py_BuildValue("{s:z}", "query", query));
+  // Never 0, which tells `trace_end` that the event isn't traced.
+  int64_t start = timings_now();
+  return start ? start : 1;
+}
+
+void trace_call_end(int64_t start, const char *event, const char *query,
+                    Py_ssize_t rows, int failed) {
+  double duration = (timings_now() - start) / 1e9;
+  if (!trace_hook) {
+    return;
+  }
+
+  PyObject *type = NULL, *value = NULL, *tb = NULL;
+  if (failed) {
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+    if (tb) {
+      PyException_SetTraceback(value, tb);
+    }
+  }
+
+  PyObject *info;
+  if (rows < 0) {
+    info = Py_BuildValue("{s:z,s:d,s:O,s:O}", "query", query, "duration",
+                         duration, "rows", Py_None, "error",
+                         value ? value : Py_None);
+  } else {
+    info = Py_BuildValue("{s:z,s:d,s:n,s:O}", "query", query, "duration",
+                         duration, "rows", rows, "error",
+                         value ? value : Py_None);
+  }
+  trace_call(event, "end", info);
+
+  if (failed) {
+    PyErr_Restore(type, value, tb);
+  }
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2016-2020 Memgraph Ltd. [https://memgraph.com]
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PYMGCLIENT_TRACE_H
+#define PYMGCLIENT_TRACE_H
+
+#include <Python.h>
+
+#include <stdint.h>
+
+// The callable set by `mgclient.set_trace_hook()`, or NULL. Every traced
+// operation checks it first, so tracing costs nothing else while unset.
+extern PyObject *trace_hook;
+
+int64_t trace_call_start(const char *event, const char *query);
+void trace_call_end(int64_t start, const char *event, const char *query,
+                    Py_ssize_t rows, int failed);
+
+// Reports the start of `event` (with `query`, which may be NULL) to the trace
+// hook. Returns the start time to pass to `trace_end`, or 0 if the hook is
+// unset.
+static inline int64_t trace_start(const char *event, const char *query) {
+  return trace_hook ? trace_call_start(event, query) : 0;
+}
+
+// Reports the end of an event started by `trace_start`. `rows` is the number of
+// rows produced (or -1 if not known) and `failed` tells whether it ended with
+// the exception that is currently set, which is left in place.
+static inline void trace_end(int64_t start, const char *event,
+                             const char *query, Py_ssize_t rows, int failed) {
+  if (start) {
+    trace_call_end(start, event, query, rows, failed);
+  }
+}
+
+#endif
@@ -396,3 +396,166 @@ def test_autocommit_failure(memgraph_server):
     assert conn.status == mgclient.CONN_STATUS_READY
     cursor.execute("RETURN 5")
     assert conn.status == mgclient.CONN_STATUS_IN_TRANSACTION
+
+
+def test_connection_stats(memgraph_server):
+    host, port, sslmode, _ = memgraph_server
+    conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+    conn.autocommit = True
+
+    stats = conn.stats
+    assert stats["queries"] == 0
+    assert stats["rows"] == 0
+
+    cursor = conn.cursor()
+    cursor.execute("UNWIND range(1, 5) AS n RETURN n")
+    stats = conn.stats
+    assert stats["queries"] == 1
+    assert stats["rows"] == 5
+    assert stats["round_trips"] == 2
+    assert stats["wait_time"] > 0
+    # Sizes are only counted while query statistics are collected.
+    assert stats["bytes_sent"] == 0
+    assert stats["bytes_received"] == 0
+
+    mgclient.enable_query_stats()
+    try:
+        cursor.execute("UNWIND range(1, 5) AS n RETURN n")
+    finally:
+        mgclient.enable_query_stats(False)
+    stats = conn.stats
+    assert stats["queries"] == 2
+    assert stats["bytes_sent"] > 0
+    assert stats["bytes_received"] > 0
+
+    with pytest.raises(mgclient.DatabaseError):
+        cursor.execute("SYNTAX ERROR")
+    stats = conn.stats
+    assert stats["queries"] == 3
+    assert stats["database_errors"] + stats["transient_errors"] == 1
+
+
+def test_connection_pool(memgraph_server):
+    host, port, sslmode, _ = memgraph_server
+    pool = mgclient.ConnectionPool(
+        min_size=1, max_size=2, host=host, port=port, sslmode=sslmode
+    )
+    assert pool.size == 1
+    assert pool.idle == 1
+
+    conn = pool.acquire()
+    assert isinstance(conn, mgclient.Connection)
+    assert pool.idle == 0
+    conn.autocommit = True
+    conn.cursor().execute("RETURN 1")
+    pool.release(conn)
+    assert pool.idle == 1
+
+    # The idle connection is reused and reset to the state of a new one.
+    again = pool.acquire()
+    assert again is conn
+    assert not again.autocommit
+    other = pool.acquire()
+    assert other is not conn
+    assert pool.size == 2
+
+    with pytest.raises(mgclient.OperationalError):
+        pool.acquire(timeout=0.1)
+
+    # An open transaction is rolled back on release.
+    cursor = other.cursor()
+    cursor.execute("CREATE (:PoolNode)")
+    pool.release(other)
+    with pytest.raises(ValueError):
+        pool.release(other)
+    cursor = pool.acquire().cursor()
+    cursor.execute("MATCH (n:PoolNode) RETURN count(n)")
+    assert cursor.fetchone() == (0,)
+
+    # Closed connections are dropped.
+    again.close()
+    pool.release(again)
+    assert pool.size == 1
+
+    pool.close()
+    with pytest.raises(mgclient.InterfaceError):
+        pool.acquire()
+
+
+def test_connection_pool_threads(memgraph_server):
+    import threading
+
+    host, port, sslmode, _ = memgraph_server
+    pool = mgclient.ConnectionPool(max_size=2, host=host, port=port, sslmode=sslmode)
+    errors = []
+
+    def work():
+        try:
+            for _ in range(20):
+                conn = pool.acquire(timeout=10)
+                try:
+                    cursor = conn.cursor()
+                    cursor.execute("RETURN 1")
+                    assert cursor.fetchall() == [(1,)]
+                finally:
+                    pool.release(conn)
+        except Exception as e:
+            errors.append(e)
+
+    threads = [threading.Thread(target=work) for _ in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    assert not errors
+    assert pool.size <= 2
+    pool.close()
+
+
+def test_connection_pool_opens_connections_without_the_gil():
+    import threading
+    import time
+
+    # A server that accepts connections but stalls the handshake for a second
+    # before hanging up.
+    listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    listener.bind(("127.0.0.1", 0))
+    listener.listen(1)
+    port = listener.getsockname()[1]
+
+    def stall():
+        peer, _ = listener.accept()
+        time.sleep(1)
+        peer.close()
+
+    server = threading.Thread(target=stall)
+    server.start()
+
+    pool = mgclient.ConnectionPool(max_size=1, host="127.0.0.1", port=port)
+    opening = threading.Event()
+    done = threading.Event()
+    errors = []
+
+    def acquire():
+        opening.set()
+        try:
+            pool.acquire()
+        except mgclient.OperationalError as e:
+            errors.append(e)
+        done.set()
+
+    ticks = 0
+    thread = threading.Thread(target=acquire)
+    thread.start()
+    opening.wait()
+    # This thread keeps running while the other one waits for the server.
+    while not done.is_set():
+        ticks += 1
+        time.sleep(0.01)
+    thread.join()
+    server.join()
+    listener.close()
+
+    assert len(errors) == 1
+    assert ticks > 10
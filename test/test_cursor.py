@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import datetime
 import sys
 import mgclient
 import pytest
@@ -212,6 +213,23 @@ class TestCursorInRegularConnection:
 
         assert cursor.description is None
 
+    def test_cursor_description_shared(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+        cursor1 = conn.cursor()
+        cursor2 = conn.cursor()
+
+        cursor1.execute("RETURN 1 AS a, 2 AS b")
+        cursor2.execute("RETURN 3 AS a, 4 AS b")
+        assert isinstance(cursor1.description, tuple)
+        assert cursor1.description is cursor2.description
+        assert [column.name for column in cursor2.description] == ["a", "b"]
+        assert cursor2.description[0].type_code is None
+
+        cursor2.execute("RETURN 3 AS a, 4 AS c")
+        assert [column.name for column in cursor2.description] == ["a", "c"]
+        assert cursor1.description is not cursor2.description
+
     def test_cursor_fetchone_without_result(self, memgraph_server):
         host, port, sslmode, _ = memgraph_server
         conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
@@ -274,6 +292,263 @@ class TestCursorInRegularConnection:
         assert sys.getrefcount(row2) == 3 - REF_COUNT_DECREMENT
 
 
+class TestConsumingCursor:
+    def test_consume_releases_fetched_rows(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        assert not conn.cursor().consume
+        cursor = conn.cursor(consume=True)
+        assert cursor.consume
+
+        cursor.execute("UNWIND range(1, 5) AS n RETURN [n]")
+        row = cursor.fetchone()
+        assert row == ([1],)
+        # Refs are the following:
+        #  * row
+        #  * the temporary reference of sys.getrefcount
+        # The cursor no longer holds the row.
+        assert sys.getrefcount(row) == 2 - REF_COUNT_DECREMENT
+
+        assert cursor.fetchmany(2) == [([2],), ([3],)]
+        assert cursor.fetchall() == [([4],), ([5],)]
+        assert cursor.fetchone() is None
+        assert cursor.rowcount == 5
+
+    def test_cursor_iteration(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        for consume in [False, True]:
+            cursor = conn.cursor(consume=consume)
+            cursor.execute("UNWIND range(1, 3) AS n RETURN n")
+            assert cursor.fetchone() == (1,)
+            assert list(cursor) == [(2,), (3,)]
+            assert list(cursor) == []
+
+        with pytest.raises(TypeError):
+            conn.cursor(True)
+
+
+class TestAdaptiveCursor:
+    def test_small_result_is_buffered(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        cursor = conn.cursor(buffer_rows=10)
+        assert cursor.buffer_rows == 10
+        assert cursor.buffer_bytes == 0
+        cursor.execute("UNWIND range(1, 5) AS n RETURN n")
+        assert cursor.rowcount == 5
+
+        # The whole result is received, so the connection is free.
+        conn.cursor().execute("RETURN 1")
+        assert cursor.fetchall() == [(n,) for n in range(1, 6)]
+
+    def test_large_result_is_streamed(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        cursor = conn.cursor(buffer_rows=3)
+        cursor.execute("UNWIND range(1, 10) AS n RETURN n")
+        assert cursor.rowcount == -1
+
+        with pytest.raises(mgclient.InterfaceError):
+            conn.cursor().execute("RETURN 1")
+        with pytest.raises(mgclient.InterfaceError):
+            cursor.close()
+
+        assert cursor.fetchone() == (1,)
+        assert cursor.fetchmany(4) == [(2,), (3,), (4,), (5,)]
+        assert list(cursor) == [(n,) for n in range(6, 11)]
+        assert cursor.rowcount == 10
+
+        cursor.execute("UNWIND range(1, 10) AS n RETURN n")
+        assert cursor.fetchall() == [(n,) for n in range(1, 11)]
+        assert cursor.rowcount == 10
+        cursor.close()
+
+    def test_byte_budget(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        cursor = conn.cursor(buffer_bytes=1)
+        cursor.execute("UNWIND range(1, 2000) AS n RETURN n, 'a string value'")
+        assert cursor.rowcount == -1
+        assert len(cursor.fetchall()) == 2000
+
+        cursor.execute("RETURN 1")
+        assert cursor.rowcount == 1
+
+        with pytest.raises(ValueError):
+            conn.cursor(buffer_rows=-1)
+
+    def test_streaming_in_transaction(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        cursor = conn.cursor(buffer_rows=2)
+        cursor.execute("UNWIND range(1, 5) AS n RETURN n")
+        with pytest.raises(mgclient.InterfaceError):
+            conn.commit()
+        assert len(cursor.fetchall()) == 5
+        conn.commit()
+
+
+class TestSpillingCursor:
+    def test_spilled_rows(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        cursor = conn.cursor(spill_bytes=100)
+        assert cursor.spill_bytes == 100
+        cursor.execute(
+            "UNWIND range(1, 100) AS n "
+            "RETURN n, toString(n), [n, 0.5], {n: n}, date('2020-01-01')"
+        )
+        assert cursor.rowcount == 100
+
+        # The connection is free, everything was received.
+        conn.cursor().execute("RETURN 1")
+
+        expected = [
+            (n, str(n), [n, 0.5], {"n": n}, datetime.date(2020, 1, 1))
+            for n in range(1, 101)
+        ]
+        assert cursor.fetchone() == expected[0]
+        assert cursor.fetchmany(50) == expected[1:51]
+        assert list(cursor) == expected[51:]
+
+        cursor.scroll(-10)
+        assert cursor.fetchall() == expected[90:]
+        cursor.scroll(0, mode="absolute")
+        assert cursor.fetchall() == expected
+
+        with pytest.raises(IndexError):
+            cursor.scroll(1)
+        with pytest.raises(mgclient.ProgrammingError):
+            cursor.scroll(0, mode="sideways")
+
+    def test_spilled_graph_values(self, memgraph_server):
+        host, port, sslmode, is_long_running = memgraph_server
+        if is_long_running:
+            pytest.skip("creates nodes")
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+        conn.autocommit = True
+
+        cursor = conn.cursor()
+        cursor.execute(
+            "CREATE p = (:A {x: 1})-[:R {y: 2}]->(:B)<-[:S]-(:C) RETURN p"
+        )
+        (expected,) = cursor.fetchone()
+
+        spilling = conn.cursor(spill_bytes=1)
+        spilling.execute("MATCH p = (:A)-[:R]->(:B)<-[:S]-(:C) RETURN p")
+        (path,) = spilling.fetchone()
+        assert path == expected
+
+    def test_scroll_not_supported(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        cursor = conn.cursor(buffer_rows=2)
+        cursor.execute("UNWIND range(1, 5) AS n RETURN n")
+        with pytest.raises(mgclient.NotSupportedError):
+            cursor.scroll(0)
+        cursor.fetchall()
+
+        with pytest.raises(ValueError):
+            conn.cursor(spill_bytes=1, buffer_rows=1)
+
+
+def test_execute_max_rows(memgraph_server):
+    host, port, sslmode, _ = memgraph_server
+    conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+    cursor = conn.cursor()
+    cursor.execute("UNWIND range(1, 100) AS n RETURN n", max_rows=3)
+    assert cursor.rowcount == 3
+    assert cursor.fetchall() == [(1,), (2,), (3,)]
+
+    # The rest of the result is only received once the connection is used
+    # again, and is dropped then.
+    assert conn.status == mgclient.CONN_STATUS_EXECUTING
+    assert conn.stats["rows"] == 3
+    cursor.execute("UNWIND range(1, 2) AS n RETURN n", max_rows=3)
+    assert conn.stats["rows"] == 102
+    assert cursor.fetchall() == [(1,), (2,)]
+    assert conn.status == mgclient.CONN_STATUS_READY
+
+    # Committing discards the rest as well.
+    conn.autocommit = False
+    cursor.execute("UNWIND range(1, 100) AS n RETURN n", max_rows=1)
+    conn.commit()
+    assert conn.status == mgclient.CONN_STATUS_READY
+
+    with pytest.raises(ValueError):
+        cursor.execute("RETURN 1", max_rows=-1)
+    with pytest.raises(mgclient.NotSupportedError):
+        conn.cursor(buffer_rows=10).execute("RETURN 1", max_rows=1)
+
+    lazy_conn = mgclient.connect(host=host, port=port, sslmode=sslmode, lazy=True)
+    with pytest.raises(mgclient.NotSupportedError):
+        lazy_conn.cursor().execute("RETURN 1", max_rows=1)
+
+    # Closing drops the rest along with the session.
+    cursor.execute("UNWIND range(1, 100) AS n RETURN n", max_rows=1)
+    conn.close()
+
+
+def test_cursor_summary(memgraph_server):
+    host, port, sslmode, _ = memgraph_server
+    conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+    cursor = conn.cursor()
+    assert cursor.summary is None
+
+    cursor.execute("UNWIND range(1, 3) AS n RETURN n")
+    summary = cursor.summary
+    assert isinstance(summary, mgclient.ResultSummary)
+    assert summary.type == "r"
+    assert summary.plan_execution_time >= 0
+    assert summary.nodes_created == 0
+    assert summary.stats == {}
+
+    cursor.execute("CREATE (:SummaryNode)-[:R]->(:SummaryNode)")
+    assert cursor.summary.nodes_created == 2
+    assert cursor.summary.relationships_created == 1
+    assert cursor.summary.stats["nodes-created"] == 2
+    conn.rollback()
+
+    lazy_conn = mgclient.connect(host=host, port=port, sslmode=sslmode, lazy=True)
+    lazy_cursor = lazy_conn.cursor()
+    lazy_cursor.execute("UNWIND range(1, 3) AS n RETURN n")
+    assert lazy_cursor.summary is None
+    lazy_cursor.fetchall()
+    assert lazy_cursor.summary.type == "r"
+
+
+def test_cursor_timings(memgraph_server):
+    host, port, sslmode, _ = memgraph_server
+    conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+    cursor = conn.cursor()
+    cursor.execute("UNWIND range(1, 10) AS n RETURN n")
+    timings = cursor.timings
+    if timings is None:
+        pytest.skip("built without timings")
+
+    assert set(timings) == {"run", "pull", "fetch", "decode"}
+    assert all(t >= 0 for t in timings.values())
+    assert timings["run"] > 0
+
+    # Another query doesn't change the timings of the first one.
+    other = conn.cursor()
+    other.execute("RETURN 1")
+    assert cursor.timings == timings
+    assert other.timings != timings
+
+
 class TestCursorInAsyncConnection:
     def test_cursor_close(self, memgraph_server):
         host, port, sslmode, _ = memgraph_server
@@ -532,3 +807,125 @@ class TestCursorInAsyncConnection:
         # 2. temp reference in sys.getrefcount (unless Python 3.14)
         assert sys.getrefcount(row1) == 2 - REF_COUNT_DECREMENT
         assert sys.getrefcount(row2) == 2 - REF_COUNT_DECREMENT
+
+
+class TestPreparedQuery:
+    def test_prepared_execute(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        prepared = conn.prepare("RETURN $x + $y AS sum")
+        assert prepared.query == "RETURN $x + $y AS sum"
+
+        cursor = prepared.execute({"x": 1, "y": 2})
+        assert cursor is prepared.cursor
+        assert cursor.fetchall() == [(3,)]
+        description = cursor.description
+        assert [column.name for column in description] == ["sum"]
+
+        assert prepared.execute({"y": 10, "x": 20}).fetchall() == [(30,)]
+        assert prepared.cursor.description is description
+
+    def test_prepared_parameters_change(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        conn.autocommit = True
+
+        prepared = conn.prepare("RETURN $x")
+        assert prepared.execute({"x": 1}).fetchall() == [(1,)]
+        assert prepared.execute({"x": 1, "unused": 2}).fetchall() == [(1,)]
+        assert prepared.execute({"x": "a"}).fetchall() == [("a",)]
+
+        with pytest.raises(mgclient.DatabaseError):
+            prepared.execute({"z": 1})
+        with pytest.raises(mgclient.DatabaseError):
+            prepared.execute()
+        assert prepared.execute({"x": [1]}).fetchall() == [([1],)]
+
+    def test_prepared_without_parameters(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        prepared = conn.prepare("UNWIND [1, 2] AS n RETURN n")
+        assert prepared.execute().fetchall() == [(1,), (2,)]
+        assert prepared.execute(None).fetchall() == [(1,), (2,)]
+
+    def test_prepared_closed_connection(self, memgraph_server):
+        host, port, sslmode, _ = memgraph_server
+        conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+
+        prepared = conn.prepare("RETURN 1")
+        conn.close()
+
+        with pytest.raises(mgclient.InterfaceError):
+            prepared.execute()
+        with pytest.raises(mgclient.InterfaceError):
+            conn.prepare("RETURN 1")
+
+
+def test_query_stats(memgraph_server):
+    host, port, sslmode, _ = memgraph_server
+    conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+    cursor = conn.cursor()
+
+    mgclient.query_stats(reset=True)
+    cursor.execute("UNWIND range(1, 3) AS n RETURN n")
+    assert mgclient.query_stats() == {}
+
+    mgclient.enable_query_stats()
+    try:
+        cursor.execute("UNWIND range(1, 3) AS n RETURN n")
+        cursor.execute("UNWIND  range(1, 5) AS n // comment\nRETURN n")
+        cursor.execute("RETURN 'a' AS s")
+        stats = mgclient.query_stats(reset=True)
+    finally:
+        mgclient.enable_query_stats(False)
+
+    unwind = stats["UNWIND range(?, ?) AS n RETURN n"]
+    assert unwind["calls"] == 2
+    assert unwind["rows"] == 8
+    assert unwind["bytes"] > 0
+    assert unwind["total_time"] >= unwind["max_time"] > 0
+    assert stats["RETURN ? AS s"]["calls"] == 1
+    assert mgclient.query_stats() == {}
+
+
+def test_trace_hook(memgraph_server):
+    host, port, sslmode, _ = memgraph_server
+    conn = mgclient.connect(host=host, port=port, sslmode=sslmode)
+    cursor = conn.cursor()
+
+    events = []
+    mgclient.set_trace_hook(lambda event, phase, info: events.append((event, phase, info)))
+    try:
+        cursor.execute("UNWIND range(1, 3) AS n RETURN n")
+        conn.rollback()
+        with pytest.raises(mgclient.DatabaseError):
+            cursor.execute("SYNTAX ERROR")
+    finally:
+        mgclient.set_trace_hook(None)
+
+    assert [(event, phase) for event, phase, _ in events] == [
+        ("execute", "start"),
+        ("begin", "start"),
+        ("begin", "end"),
+        ("execute", "end"),
+        ("rollback", "start"),
+        ("rollback", "end"),
+        ("execute", "start"),
+        ("begin", "start"),
+        ("begin", "end"),
+        ("execute", "end"),
+    ]
+    _, _, info = events[3]
+    assert info["query"] == "UNWIND range(1, 3) AS n RETURN n"
+    assert info["rows"] == 3
+    assert info["duration"] > 0
+    assert info["error"] is None
+    _, _, info = events[9]
+    assert isinstance(info["error"], mgclient.DatabaseError)
+    assert info["rows"] is None
+
+    with pytest.raises(TypeError):
+        mgclient.set_trace_hook(1)
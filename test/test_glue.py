@@ -125,6 +125,76 @@ def test_list(memgraph_connection):
     assert sys.getrefcount(value_from_result) == 3 - REF_COUNT_DECREMENT
 
 
+def test_tuple_and_set_params(memgraph_connection):
+    conn = memgraph_connection
+    cursor = conn.cursor()
+
+    cursor.execute("RETURN $value", {"value": (1, "a", (2, None))})
+    assert cursor.fetchall() == [([1, "a", [2, None]],)]
+
+    cursor.execute("RETURN $value", {"value": ()})
+    assert cursor.fetchall() == [([],)]
+
+    cursor.execute("RETURN $value", {"value": range(3)})
+    assert cursor.fetchall() == [([0, 1, 2],)]
+
+    cursor.execute("RETURN $value", {"value": frozenset([7])})
+    assert cursor.fetchall() == [([7],)]
+
+    cursor.execute("RETURN $value", {"value": {1, 2, 3}})
+    assert sorted(cursor.fetchall()[0][0]) == [1, 2, 3]
+
+    with pytest.raises(ValueError):
+        cursor.execute("RETURN $value", {"value": b"bytes"})
+
+
+def test_mapping_params(memgraph_connection):
+    import collections
+    import types
+
+    conn = memgraph_connection
+    cursor = conn.cursor()
+
+    cursor.execute("RETURN $value", {"value": types.MappingProxyType({"x": 1})})
+    assert cursor.fetchall() == [({"x": 1},)]
+
+    cursor.execute("RETURN $value", {"value": collections.OrderedDict(a=[1], b={"c": 2})})
+    assert cursor.fetchall() == [({"a": [1], "b": {"c": 2}},)]
+
+    cursor.execute("RETURN $x + $y", types.MappingProxyType({"x": 1, "y": 2}))
+    assert cursor.fetchall() == [(3,)]
+
+    with pytest.raises(ValueError):
+        cursor.execute("RETURN $value", {"value": types.MappingProxyType({1: 1})})
+
+    with pytest.raises(TypeError):
+        cursor.execute("RETURN 1", [("x", 1)])
+
+
+def test_iterator(memgraph_connection):
+    conn = memgraph_connection
+    cursor = conn.cursor()
+
+    cursor.execute("RETURN $value", {"value": (x * x for x in range(5))})
+    assert cursor.fetchall() == [([0, 1, 4, 9, 16],)]
+
+    cursor.execute("RETURN $value", {"value": iter([])})
+    assert cursor.fetchall() == [([],)]
+
+    cursor.execute("UNWIND $rows AS row RETURN count(row)", {"rows": ({"id": i} for i in range(10000))})
+    assert cursor.fetchall() == [(10000,)]
+
+    def failing():
+        yield 1
+        raise KeyError("boom")
+
+    with pytest.raises(KeyError):
+        cursor.execute("RETURN $value", {"value": failing()})
+
+    with pytest.raises(ValueError):
+        cursor.execute("RETURN $value", {"value": iter([1, object()])})
+
+
 def test_map(memgraph_connection):
     conn = memgraph_connection
     cursor = conn.cursor()
@@ -261,6 +331,21 @@ def test_date(memgraph_connection):
     assert result == [(datetime.date(1994, 7, 12),)]
 
 
+@pytest.mark.temporal
+def test_date_far_from_epoch(memgraph_connection):
+    conn = memgraph_connection
+    cursor = conn.cursor()
+    for value in [
+        datetime.date(1, 1, 1),
+        datetime.date(1600, 2, 29),
+        datetime.date(1969, 12, 31),
+        datetime.date(2100, 3, 1),
+        datetime.date(9999, 12, 31),
+    ]:
+        cursor.execute("RETURN $value", {"value": value})
+        assert cursor.fetchall() == [(value,)]
+
+
 @pytest.mark.temporal
 def test_datetime(memgraph_connection):
     conn = memgraph_connection
@@ -278,6 +363,20 @@ def test_datetime_with_offset_timezone(memgraph_connection):
     result = cursor.fetchall()
     assert result == [(datetime.datetime(2004, 7, 11, 12, 13, 14, 15, tzinfo=datetime.timezone(datetime.timedelta(hours=3))),)]
 
+@pytest.mark.temporal
+def test_datetimes_sharing_offset_timezone(memgraph_connection):
+    conn = memgraph_connection
+    cursor = conn.cursor()
+    west = datetime.timezone(datetime.timedelta(hours=-3, minutes=-30))
+    east = datetime.timezone(datetime.timedelta(hours=5, minutes=45))
+    values = [
+        datetime.datetime(1950, 1, 2, 3, 4, 5, 6, tzinfo=west),
+        datetime.datetime(2024, 2, 29, 23, 59, 59, 999999, tzinfo=west),
+        datetime.datetime(2024, 2, 29, 23, 59, 59, 999999, tzinfo=east),
+    ]
+    cursor.execute("RETURN $values", {"values": values})
+    assert cursor.fetchall() == [(values,)]
+
 @pytest.mark.temporal
 def test_datetime_with_named_timezone(memgraph_connection):
     conn = memgraph_connection
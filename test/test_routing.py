@@ -15,16 +15,20 @@
 """Tests for client-side routing (``connect(routing=True, ...)`` and
 :class:`mgclient.Router`).
 
-These exercise the Python facade over libmgclient's routing engine. The engine
-itself -- routing-table parsing and caching, read round-robin, coordinator
-failover and the managed-transaction retry loop -- is unit-tested in
-libmgclient's own suite (``tests/routing.cpp``); the cluster-gated tests here
-confirm the facade wires it up correctly end to end. They are skipped unless
+These exercise the Python facade over the routing engine. Routing-table
+parsing and coordinator failover are unit-tested in libmgclient's own suite
+(``tests/routing.cpp``); the cluster-gated tests here confirm the engine works
+end to end. They are skipped unless
 ``MEMGRAPH_HA_COORDINATOR_HOST`` is set. The cluster's advertised addresses must
 be directly reachable from the test runner (as they are on the shared CI Docker
 network).
 """
 
+import os
+import signal
+import threading
+import time
+
 import mgclient
 import pytest
 
@@ -210,6 +214,52 @@ def test_connect_routing_fails_over_across_candidates(ha_cluster):
     conn.close()
 
 
+def test_connect_routing_shares_routers():
+    from mgclient import routing
+
+    kwargs = {"host": "127.0.0.1", "port": 7687, "username": "user"}
+    try:
+        router = routing._cached_router(None, {"region": "eu"}, kwargs)
+        assert routing._cached_router(None, {"region": "eu"}, dict(kwargs)) is router
+        assert routing._cached_router(None, {"region": "us"}, kwargs) is not router
+        assert (
+            routing._cached_router(
+                None, {"region": "eu"}, dict(kwargs, username="other")
+            )
+            is not router
+        )
+
+        for port in range(routing._MAX_CACHED_ROUTERS + 1):
+            routing._cached_router(None, None, dict(kwargs, port=port))
+        assert len(routing._routers) == routing._MAX_CACHED_ROUTERS
+    finally:
+        routing._routers.clear()
+
+
+@pytest.mark.skipif(not hasattr(os, "fork"), reason="requires os.fork")
+def test_connect_routing_routers_not_shared_across_fork():
+    from mgclient import routing
+
+    kwargs = {"host": "127.0.0.1", "port": 7687}
+    try:
+        router = routing._cached_router(None, None, kwargs)
+        pid = os.fork()
+        if pid == 0:
+            # The child starts with an empty cache and keeps the parent's
+            # router (and its sessions) alive without using it.
+            ok = (
+                not routing._routers
+                and routing._cached_router(None, None, kwargs) is not router
+                and router in routing._inherited_routers
+            )
+            os._exit(0 if ok else 1)
+        _, status = os.waitpid(pid, 0)
+        assert os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0
+        assert routing._cached_router(None, None, kwargs) is router
+    finally:
+        routing._routers.clear()
+
+
 @requires_ha_cluster
 def test_connect_routing_all_candidates_unreachable(ha_cluster):
     host, port = ha_cluster
@@ -282,6 +332,46 @@ def test_router_refresh_succeeds(ha_cluster):
     router.refresh()
 
 
+@requires_ha_cluster
+def test_router_refresh_is_single_flight(ha_cluster):
+    host, port = ha_cluster
+
+    # Concurrent refreshes share one fetch, so the resolver (consulted for the
+    # coordinators during a fetch) never runs for two of them at once.
+    lock = threading.Lock()
+    running = [0]
+    most_running = [0]
+
+    def resolver(address):
+        with lock:
+            running[0] += 1
+            most_running[0] = max(most_running[0], running[0])
+        time.sleep(0.05)
+        with lock:
+            running[0] -= 1
+        return [address]
+
+    router = Router(host=host, port=port, resolver=resolver)
+    barrier = threading.Barrier(8)
+    errors = []
+
+    def refresh():
+        barrier.wait()
+        try:
+            router.refresh()
+        except Exception as exc:
+            errors.append(exc)
+
+    threads = [threading.Thread(target=refresh) for _ in range(8)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert errors == []
+    assert most_running[0] <= 1
+    assert router.routing_table["write"]
+
+
 # ---------------------------------------------------------------------------
 # Managed transactions (cluster-gated).
 # ---------------------------------------------------------------------------
@@ -311,6 +401,312 @@ def test_execute_write_and_read_roundtrip(ha_cluster):
     )
 
 
+@requires_ha_cluster
+def test_execute_read_timeout_bounds_retries(ha_cluster):
+    host, port = ha_cluster
+    router = Router(host=host, port=port, max_retries=100, retry_backoff=1.0)
+    calls = []
+
+    def work(cursor):
+        calls.append(time.monotonic())
+        raise mgclient.TransientError("simulated failover")
+
+    # The second backoff (2 s) would end past the deadline, so the last
+    # transient error is raised after two attempts instead.
+    start = time.monotonic()
+    with pytest.raises(mgclient.TransientError):
+        router.execute_read(work, timeout=2.5)
+    assert len(calls) == 2
+    assert time.monotonic() - start < 2.5
+
+    with pytest.raises(ValueError):
+        router.execute_read(work, timeout=-1)
+
+
+@requires_ha_cluster
+@pytest.mark.skipif(
+    not hasattr(signal, "pthread_kill"), reason="needs signal.pthread_kill"
+)
+def test_execute_write_backoff_is_interruptible(ha_cluster):
+    host, port = ha_cluster
+    router = Router(host=host, port=port, max_retries=100, retry_backoff=30.0)
+
+    def work(cursor):
+        raise mgclient.TransientError("simulated failover")
+
+    timer = threading.Timer(
+        0.5, signal.pthread_kill, (threading.main_thread().ident, signal.SIGINT)
+    )
+    timer.start()
+    start = time.monotonic()
+    try:
+        with pytest.raises(KeyboardInterrupt):
+            router.execute_write(work)
+    finally:
+        timer.cancel()
+    assert time.monotonic() - start < 10
+
+
+@requires_ha_cluster
+def test_router_tracks_instance_load(ha_cluster):
+    host, port = ha_cluster
+    router = Router(host=host, port=port)
+
+    def read(cursor):
+        cursor.execute("RETURN 1")
+        return cursor.fetchall()
+
+    for _ in range(10):
+        router.execute_read(read)
+    reads = set(router.routing_table["read"])
+    measured = {
+        address: info
+        for address, info in router.instances.items()
+        if address in reads and info["latency"] is not None
+    }
+    assert measured
+    assert all(info["latency"] >= 0 for info in measured.values())
+    assert all(info["in_flight"] == 0 for info in measured.values())
+
+    conn = router.connect(access_mode="READ")
+    assert sum(info["in_flight"] for info in router.instances.values()) == 1
+    conn.close()
+    assert sum(info["in_flight"] for info in router.instances.values()) == 0
+
+
+@requires_ha_cluster
+def test_router_circuit_breaker_skips_dead_replica(ha_cluster):
+    host, port = ha_cluster
+
+    # As in test_connect_routing_fails_over_across_candidates, the first
+    # replica resolved is made unreachable. Relies on the cluster having more
+    # than one replica.
+    killed = []
+    dead_lookups = []
+
+    def resolver(address):
+        if not killed:
+            killed.append(address)
+        if address == killed[0]:
+            dead_lookups.append(address)
+            return ["127.0.0.1:1"]
+        return [address]
+
+    router = Router(
+        host=host,
+        port=port,
+        resolver=resolver,
+        max_idle_sessions=0,
+        failure_threshold=1,
+        failure_cooldown=60,
+    )
+    # Fetch the table first, so that only data instances are remapped.
+    assert router.routing_table["read"]
+    killed.clear()
+    dead_lookups.clear()
+
+    def read(cursor):
+        cursor.execute("RETURN 1")
+        return cursor.fetchall()[0][0]
+
+    for _ in range(10):
+        assert router.execute_read(read) == 1
+    # Once the dead replica failed, its circuit is open and it isn't tried.
+    assert len(dead_lookups) <= 1
+    if dead_lookups:
+        assert router.instances[killed[0]]["circuit_open"]
+
+
+@requires_ha_cluster
+def test_execute_read_hedges_slow_reads(ha_cluster):
+    host, port = ha_cluster
+    router = Router(host=host, port=port)
+    calls = []
+
+    def work(cursor):
+        calls.append(cursor)
+        if len(calls) == 1:
+            time.sleep(3)  # a stalled replica
+        cursor.execute("RETURN 1")
+        return cursor.fetchall()[0][0]
+
+    start = time.monotonic()
+    assert router.execute_read(work, hedge_after=0.1) == 1
+    assert time.monotonic() - start < 2
+    assert len(calls) == 2
+
+    # Without a stall, no second attempt is made.
+    fast_calls = []
+
+    def fast(cursor):
+        fast_calls.append(cursor)
+        cursor.execute("RETURN 1")
+        return cursor.fetchall()[0][0]
+
+    assert router.execute_read(fast, hedge_after=1.0) == 1
+    assert len(fast_calls) == 1
+
+    with pytest.raises(ValueError):
+        router.execute_read(work, hedge_after=-1)
+
+
+@requires_ha_cluster
+def test_execute_read_hedge_claims_replica_before_connecting(ha_cluster):
+    host, port = ha_cluster
+    replicas = set()
+    connected = []
+
+    def resolver(address):
+        if address in replicas:
+            connected.append(address)
+            if len(connected) == 1:
+                time.sleep(3)  # a replica slow to accept connections
+        return [address]
+
+    # Without idle sessions, each attempt has to connect.
+    router = Router(host=host, port=port, resolver=resolver, max_idle_sessions=0)
+    replicas.update(router.routing_table["read"])
+    if len(replicas) < 2:
+        pytest.skip("requires at least two replicas")
+
+    def work(cursor):
+        cursor.execute("RETURN 1")
+        return cursor.fetchall()[0][0]
+
+    start = time.monotonic()
+    assert router.execute_read(work, hedge_after=0.1) == 1
+    assert time.monotonic() - start < 2
+    # The hedge didn't pick the replica the first attempt was still connecting
+    # to.
+    assert len(connected) == 2
+    assert connected[0] != connected[1]
+
+
+@requires_ha_cluster
+def test_router_shared_by_threads(ha_cluster):
+    host, port = ha_cluster
+    router = Router(host=host, port=port)
+    barrier = threading.Barrier(8)
+    results = []
+    errors = []
+
+    def work(i):
+        def read(cursor):
+            cursor.execute("RETURN $i", {"i": i})
+            return cursor.fetchall()[0][0]
+
+        barrier.wait()
+        try:
+            for _ in range(5):
+                results.append(router.execute_read(read))
+                results.append(router.execute_write(read))
+        except Exception as exc:
+            errors.append(exc)
+
+    threads = [threading.Thread(target=work, args=(i,)) for i in range(8)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert errors == []
+    assert sorted(results) == sorted(list(range(8)) * 10)
+
+
+@requires_ha_cluster
+def test_router_reuses_idle_sessions(ha_cluster):
+    host, port = ha_cluster
+    router = Router(host=host, port=port, max_idle_sessions=1)
+
+    def one(cursor):
+        cursor.execute("RETURN 1")
+        return cursor.fetchall()[0][0]
+
+    assert router.execute_write(one) == 1
+    main = router.routing_table["write"][0]
+    assert router.idle_sessions == {main: 1}
+
+    # The idle session is reused rather than a second one being opened.
+    assert router.execute_write(one) == 1
+    assert router.idle_sessions == {main: 1}
+
+    # A connection handed out by the router takes the idle session and gives
+    # it back when closed.
+    conn = router.connect(access_mode="WRITE")
+    assert router.idle_sessions == {}
+    conn.close()
+    assert router.idle_sessions == {main: 1}
+
+    # A cursor kept by the work can't be used once the session is reused.
+    kept = router.execute_write(lambda cursor: cursor)
+    with pytest.raises(mgclient.InterfaceError):
+        kept.execute("RETURN 1")
+
+
+@requires_ha_cluster
+def test_router_closes_sessions_idle_for_too_long(ha_cluster):
+    host, port = ha_cluster
+    resolved = []
+
+    def resolver(address):
+        resolved.append(address)
+        return [address]
+
+    router = Router(
+        host=host, port=port, resolver=resolver, max_idle_sessions=1, max_idle=0.5
+    )
+
+    def one(cursor):
+        cursor.execute("RETURN 1")
+        return cursor.fetchall()[0][0]
+
+    assert router.execute_write(one) == 1
+    main = router.routing_table["write"][0]
+    assert router.execute_write(one) == 1
+    assert resolved.count(main) == 1
+
+    # The idle session is too old to be trusted, so a new one is opened.
+    time.sleep(1)
+    assert router.execute_write(one) == 1
+    assert resolved.count(main) == 2
+    assert router.idle_sessions == {main: 1}
+
+
+def test_router_background_refresh_must_be_a_fraction():
+    with pytest.raises(ValueError):
+        Router(host="127.0.0.1", port=7687, background_refresh=1.5)
+
+
+@requires_ha_cluster
+def test_router_background_refresh(ha_cluster):
+    host, port = ha_cluster
+    ttl = Router(host=host, port=port).routing_table["ttl"]
+    # Refresh about two seconds after each fetch.
+    fraction = min(0.5, 2 / ttl) if ttl > 0 else 0.5
+    router = Router(host=host, port=port, background_refresh=fraction)
+    try:
+        # The first table is left to the router's first use.
+        time.sleep(0.5)
+        assert router._router.table_age() is None
+        assert router.routing_table["write"]
+
+        # Later tables are fetched by the background thread alone, well
+        # before they expire.
+        last_age, _ = router._router.table_age()
+        deadline = time.monotonic() + 10
+        while time.monotonic() < deadline:
+            time.sleep(0.1)
+            age, _ = router._router.table_age()
+            if age < last_age:
+                break
+            last_age = age
+        else:
+            pytest.fail("the background thread didn't refresh the table")
+        assert last_age < max(ttl, 3)
+    finally:
+        router.close()
+    assert router.idle_sessions == {}
+
+
 # ---------------------------------------------------------------------------
 # Error-classification helper (no cluster needed).
 # ---------------------------------------------------------------------------